@@ -1,7 +1,7 @@
 /** Spiritless_po include file.
     \file spiritless_po.h
     \author OOTA, Masato
-    \copyright Copyright © 2019, 2022 OOTA, Masato
+    \copyright Copyright © 2019, 2022, 2026 OOTA, Masato
     \par License Boost
     \parblock
       This program is distributed under the Boost Software License Version 1.0.
@@ -13,5 +13,7 @@
 #define SPIRITLESS_PO_H_
 
 #include "spiritless_po/Catalog.h"
+#include "spiritless_po/LazyCatalog.h"
+#include "spiritless_po/PoWriter.h"
 
 #endif // SPIRITLESS_PO_H_
@@ -13,21 +13,34 @@
 #define SPIRITLESS_PO_CATALOG_H_
 
 #include "Common.h"
+#include "Decompressor.h"
+#include "FileBuffer.h"
+#include "LoadProfile.h"
 #include "MetadataParser.h"
 #include "PluralParser.h"
 #include "PoParser.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
 #include <functional>
-#include <iosfwd>
+#include <istream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace spiritless_po {
+    class LazyCatalog;
+
     /** Class Catalog handles a catalog that contains original and translated messages, which come from PO format streams.
 
         You need only to use this class and not directly to use other classes under include/spiritless_po/.
@@ -100,11 +113,105 @@ namespace spiritless_po {
         /** Add some PO entries.
             \param [in] is An input stream that contains PO entries.
             \return true if no error is existed.
+            \note The stream is read by the large blocks through is.rdbuf(), and the blocks are parsed directly.
+            \note A gzip or zstd compressed stream is decompressed while it's parsed. (See Decompressor.h)
             \note This function doesn't change any existed entries, that is a translated text (msgstr) that corresponds to an existed original text (msgid), and also metadata if it's already existed.
             \note An entry isn't added if the msgstr (including msgstr[0]) is empty.
         */
         bool Add(std::istream &is);
 
+        /** Add PO entries, parsing the text on some threads.
+            \param [in] begin The beginning of the text that contains PO entries.
+            \param [in] end The end of the text.
+            \param [in] threads The maximum number of the threads, or 0 to use std::thread::hardware_concurrency().
+            \return true if no error is existed.
+            \note The result is the same as Add(begin, end).
+        */
+        bool AddParallel(const char *begin, const char *end, unsigned int threads = 0);
+
+        /** Type of the options for AddFiles(). */
+        struct AddFilesOptionsT {
+            /** Create the default options. */
+            AddFilesOptionsT();
+
+            unsigned int threads; /**< The number of the threads, or 0 to use std::thread::hardware_concurrency(). It's the number of the tasks for executor if executor is set. */
+            std::function<void(std::function<void()>)> executor; /**< The function that runs a task on any thread, or empty to use the threads created by AddFiles(). It's called only on the thread that calls AddFiles(). */
+        };
+
+        /** Add PO entries from some files, parsing them concurrently.
+            \param [in] paths The paths of the PO files.
+            \param [in] options The options.
+            \return true if no error is existed.
+            \note The result is the same as AddFile() in the order of paths, except that each error message is prefixed with the path and ": ".
+            \note Each file is parsed by the thread that is free first, and a large uncompressed file is split into the chunks like AddParallel(), so a large file doesn't leave the other threads idle.
+        */
+        bool AddFiles(const std::vector<std::string> &paths, const AddFilesOptionsT &options = AddFilesOptionsT());
+
+        /** This class adds the PO entries that are given in chunks to a catalog.
+
+            The chunks are parsed while they arrive, so the caller doesn't need to hold the whole text.
+            \attention The catalog must outlive the instance, and must not be moved while the instance is used.
+        */
+        class IncrementalAdder {
+        public:
+            /** Create an adder for a catalog.
+                \param [in] target The catalog to add the entries.
+            */
+            explicit IncrementalAdder(Catalog &target);
+
+            /** Add the PO entries that are finished by a chunk.
+                \param [in] data The pointer to the chunk.
+                \param [in] size The size of the chunk.
+                \return true if no error is existed.
+            */
+            bool Feed(const char *data, std::size_t size);
+
+            /** Add the rest of the PO entries at the end of the text.
+                \return true if no error is existed.
+                \note The adder is reset to wait for the beginning of a new text.
+            */
+            bool Finish();
+
+        private:
+            Catalog &catalog;
+            PoParser::IncrementalParser parser;
+        };
+
+        /** Add PO entries from a file.
+            \param [in] path The path of the PO file.
+            \return true if no error is existed.
+            \note A regular file is mapped into the memory and parsed directly, and the other files, such as pipes, are read by the large blocks.
+            \note A gzip or zstd compressed file is decompressed while it's parsed. (See Decompressor.h)
+            \note This function doesn't change any existed entries, that is a translated text (msgstr) that corresponds to an existed original text (msgid), and also metadata if it's already existed.
+            \note An entry isn't added if the msgstr (including msgstr[0]) is empty.
+        */
+        bool AddFile(const char *path);
+
+        /** Type of the header of a PO file, which is read by ScanHeader(). */
+        struct HeaderT {
+            MetadataParser::MapT metadata; /**< The metadata, or empty if the first entry isn't the metadata. */
+            PluralParser::FunctionType pluralFunction; /**< The function that calculates the index of msgstr[n]. */
+            std::size_t maxPlurals; /**< The maximum index of msgstr[n]. */
+            std::vector<std::string> errors; /**< The strings that describe the errors in the header. */
+        };
+
+        /** Read only the metadata of a PO file.
+            \param [in] path The path of the PO file.
+            \return The header of the file.
+            \note The file is read by the small blocks until the first entry is finished, and the rest of the file isn't read.
+            \note The metadata, the plural function, and the errors are the same as AddFile(path) sets, if the first entry is the metadata.
+            \note A gzip or zstd compressed file is decompressed. (See Decompressor.h)
+        */
+        static HeaderT ScanHeader(const char *path);
+
+        /** Read only the metadata of a PO stream.
+            \param [in] is An input stream that contains PO entries.
+            \return The header of the stream.
+            \note The stream is read by the small blocks until the first entry is finished, and the rest of the stream isn't read.
+            \note The metadata, the plural function, and the errors are the same as Add(is) sets, if the first entry is the metadata.
+        */
+        static HeaderT ScanHeader(std::istream &is);
+
         /** Add another catalog contents.
             \param [in] a A catalog to add the entries.
             \note This function doesn't change any existed entries, that is a translated text (msgstr) that corresponds to an existed original text (msgid), and also metadata if it's already existed.
@@ -189,6 +296,23 @@ namespace spiritless_po {
          */
         void ClearStatistics() noexcept;
 
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+        /** Type of the profile of the loading. */
+        typedef spiritless_po::LoadProfileT LoadProfileT;
+
+        /** Get the profile of the loading by Add(), AddParallel(), AddFile(), AddFiles(), and IncrementalAdder.
+            \return The profile.
+            \note This function exists only if SPIRITLESS_PO_DEBUG_LOAD_PROFILE is defined.
+            \note The parsing in the worker threads of AddParallel() and AddFiles() isn't profiled, but it's included in total.
+         */
+        const LoadProfileT &GetLoadProfile() const noexcept;
+
+        /** Clear the profile of the loading.
+            \note This function exists only if SPIRITLESS_PO_DEBUG_LOAD_PROFILE is defined.
+         */
+        void ClearLoadProfile() noexcept;
+#endif
+
 
         /** Type of the string index.
 
@@ -203,6 +327,15 @@ namespace spiritless_po {
         };
 
     private:
+        // LazyCatalog shares the metadata handling.
+        friend class LazyCatalog;
+
+        bool AddEntries(std::vector<PoParser::PoEntryT> &newEntries);
+        static void ParseMetadata(const std::string &metadataString, MetadataParser::MapT &metadata,
+            PluralParser::FunctionType &pluralFunction, std::size_t &maxPlurals, std::vector<std::string> &errors);
+        static std::unique_ptr<FileBuffer> OpenFile(const std::string &path);
+        static bool ReadEntries(const FileBuffer &file, std::vector<PoParser::PoEntryT> &entries, std::string &error);
+
         MetadataParser::MapT metadata;
         std::unordered_map<std::string, IndexDataT> index;
         std::vector<std::string> stringTable;
@@ -210,6 +343,9 @@ namespace spiritless_po {
         std::size_t maxPlurals;
         std::vector<std::string> errors;
         StatisticsT statistics;
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+        LoadProfileT loadProfile;
+#endif
 
     public:
         // Debugging and managing functions
@@ -237,6 +373,9 @@ namespace spiritless_po {
     inline Catalog::Catalog()
         : metadata(), index(), stringTable(), pluralFunction(),
           maxPlurals(0), errors(), statistics{}
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+          , loadProfile()
+#endif
     {
     }
 
@@ -261,7 +400,13 @@ namespace spiritless_po {
     template <typename INP, typename Sentinel>
     bool Catalog::Add(INP &&begin, Sentinel &&end)
     {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(loadProfile);
         std::vector<PoParser::PoEntryT> newEntries(PoParser::GetEntries(begin, end));
+        return AddEntries(newEntries);
+    }
+
+    inline bool Catalog::AddEntries(std::vector<PoParser::PoEntryT> &newEntries)
+    {
         statistics.totalCount += newEntries.size();
         const size_t prevIndexSize = index.size();
         for (auto &it : newEntries) {
@@ -272,32 +417,26 @@ namespace spiritless_po {
                 if (it.msgid.empty()) {
                     statistics.metadataCount++;
                     if (metadata.empty()) {
-                        const std::string &metadataString = it.msgstr[0];
-                        metadata = MetadataParser::Parse(metadataString);
-                        unsigned long nplurals = 2;
-                        MetadataParser::GetNPlurals(metadataString, nplurals);
-                        if (nplurals == 0) {
-                            errors.emplace_back("nplurals must be more than 0; ignored.");
-                            nplurals = 1;
-                        }
-                        maxPlurals = nplurals - 1;
-                        std::string plural("n!=1");
-                        MetadataParser::GetPlural(metadataString, plural);
-                        try {
-                            pluralFunction = PluralParser::Parse(plural);
-                        } catch (PluralParser::ExpressionError &e) {
-                            const size_t col = std::distance(plural.cbegin(), e.Where());
-                            errors.emplace_back("Column#" + std::to_string(col + 1)
-                                + " in the plural expression \"" + plural + "\": " + e.what());
-                        }
+                        ParseMetadata(it.msgstr[0], metadata, pluralFunction, maxPlurals, errors);
                     }
                 }
-                if (index.find(it.msgid) == index.end()) {
-                    IndexDataT idx;
-                    idx.stringTableIndex = stringTable.size();
-                    idx.totalPlurals = it.msgstr.size();
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+                {
+                    // The hash is calculated again by emplace(), so it's measured only to know its proportion.
+                    SPIRITLESS_PO_LOAD_PROFILE_TIMER(hash);
+                    volatile std::size_t hash = index.hash_function()(it.msgid);
+                    (void)hash;
+                }
+                SPIRITLESS_PO_LOAD_PROFILE_COUNT(hash, it.msgid.size(), 1);
+#endif
+                SPIRITLESS_PO_LOAD_PROFILE_TIMER(index);
+                SPIRITLESS_PO_LOAD_PROFILE_COUNT(index, 0, 1);
+                IndexDataT idx;
+                idx.stringTableIndex = stringTable.size();
+                idx.totalPlurals = it.msgstr.size();
+                // The parsed strings are moved into the catalog without copying.
+                if (index.emplace(std::move(it.msgid), idx).second) {
                     stringTable.insert(stringTable.end(), std::make_move_iterator(it.msgstr.begin()), std::make_move_iterator(it.msgstr.end()));
-                    index.emplace(it.msgid, idx);
                 } else {
                     statistics.discardedCount++;
                 }
@@ -307,11 +446,396 @@ namespace spiritless_po {
         return errors.empty();
     }
 
+    // Set the information from the metadata text.
+    inline void Catalog::ParseMetadata(const std::string &metadataString, MetadataParser::MapT &metadata,
+        PluralParser::FunctionType &pluralFunction, std::size_t &maxPlurals, std::vector<std::string> &errors)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_TIMER(metadata);
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(metadata, metadataString.size(), 1);
+        metadata = MetadataParser::Parse(metadataString);
+        unsigned long nplurals = 2;
+        MetadataParser::GetNPlurals(metadataString, nplurals);
+        if (nplurals == 0) {
+            errors.emplace_back("nplurals must be more than 0; ignored.");
+            nplurals = 1;
+        }
+        maxPlurals = nplurals - 1;
+        std::string plural("n!=1");
+        MetadataParser::GetPlural(metadataString, plural);
+        try {
+            pluralFunction = PluralParser::Parse(plural);
+        } catch (PluralParser::ExpressionError &e) {
+            const size_t col = std::distance(plural.cbegin(), e.Where());
+            errors.emplace_back("Column#" + std::to_string(col + 1)
+                + " in the plural expression \"" + plural + "\": " + e.what());
+        }
+    }
+
     inline bool Catalog::Add(std::istream &is)
     {
-        std::istreambuf_iterator<char> begin(is);
-        std::istreambuf_iterator<char> end;
-        return Add(begin, end);
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(loadProfile);
+        const std::size_t blockSize = 64 * 1024;
+        std::vector<char> buffer(blockSize);
+        std::streambuf *const buf = is.rdbuf();
+        IncrementalAdder adder(*this);
+        auto read = [&]() -> std::streamsize {
+            SPIRITLESS_PO_LOAD_PROFILE_TIMER(read);
+            const std::streamsize size = buf != nullptr ? buf->sgetn(buffer.data(), blockSize) : 0;
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(read, size > 0 ? size : 0, 1);
+            return size;
+        };
+        std::streamsize n = read();
+        // The first block has the magic bytes.
+        Decompressor decompressor(Decompressor::GetFormat(buffer.data(), n > 0 ? static_cast<std::size_t>(n) : 0));
+        auto feed = [&adder](const char *data, std::size_t size) {
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(decompress, size, 1);
+            adder.Feed(data, size);
+        };
+        while (n > 0) {
+            // The parsing in feed is excluded from decompress.
+            SPIRITLESS_PO_LOAD_PROFILE_TIMER(decompress);
+            if (!decompressor.Feed(buffer.data(), static_cast<std::size_t>(n), feed)) {
+                break;
+            }
+            n = read();
+        }
+        if (!decompressor.Finish()) {
+            // The entries after the broken data are unknown.
+            errors.push_back(decompressor.GetError());
+            return false;
+        }
+        return adder.Finish();
+    }
+
+    inline bool Catalog::AddParallel(const char *const begin, const char *const end, const unsigned int threads)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(loadProfile);
+        std::vector<PoParser::PoEntryT> newEntries(PoParser::GetEntriesParallel(begin, end, threads));
+        return AddEntries(newEntries);
+    }
+
+    inline Catalog::AddFilesOptionsT::AddFilesOptionsT()
+        : threads(0), executor()
+    {
+    }
+
+    // Open a file to read the entries.
+    inline std::unique_ptr<FileBuffer> Catalog::OpenFile(const std::string &path)
+    {
+        // The pages are read while they are parsed, so the profile has only the time to open and map the file.
+        SPIRITLESS_PO_LOAD_PROFILE_TIMER(read);
+        std::unique_ptr<FileBuffer> file(new FileBuffer(path.c_str()));
+        if (file->IsOpen()) {
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(read, file->end() - file->begin(), 1);
+        }
+        return file;
+    }
+
+    // Read the entries from a file that is opened by OpenFile().
+    // Return false and set error if it cannot be read. entries has the entries before the broken data in that case.
+    inline bool Catalog::ReadEntries(const FileBuffer &file, std::vector<PoParser::PoEntryT> &entries, std::string &error)
+    {
+        if (!file.IsOpen()) {
+            error = "Can't open the file.";
+            return false;
+        }
+        const char *begin = file.begin();
+        const char *end = file.end();
+        const Decompressor::FormatT format = Decompressor::GetFormat(begin, end - begin);
+        if (format == Decompressor::FormatT::PLAIN) {
+            entries = PoParser::GetEntries(begin, end);
+            return true;
+        }
+
+        // The decompressed text is parsed by the blocks.
+        Decompressor decompressor(format);
+        PoParser::IncrementalParser parser;
+        SPIRITLESS_PO_LOAD_PROFILE_TIMER(decompress);
+        decompressor.Feed(begin, end - begin, [&entries, &parser](const char *data, std::size_t size) {
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(decompress, size, 1);
+            std::vector<PoParser::PoEntryT> newEntries(parser.Feed(data, size));
+            entries.insert(entries.end(), std::make_move_iterator(newEntries.begin()), std::make_move_iterator(newEntries.end()));
+        });
+        if (!decompressor.Finish()) {
+            error = decompressor.GetError();
+            return false;
+        }
+        std::vector<PoParser::PoEntryT> rest(parser.Finish());
+        entries.insert(entries.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+        return true;
+    }
+
+    inline bool Catalog::AddFile(const char *const path)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(loadProfile);
+        std::vector<PoParser::PoEntryT> newEntries;
+        std::string error;
+        const bool read = ReadEntries(*OpenFile(path), newEntries, error);
+        AddEntries(newEntries);
+        if (!read) {
+            errors.push_back(std::move(error));
+        }
+        return errors.empty();
+    }
+
+    inline Catalog::HeaderT Catalog::ScanHeader(const char *const path)
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            HeaderT header;
+            header.maxPlurals = 0;
+            header.errors.emplace_back("Can't open the file.");
+            return header;
+        }
+        return ScanHeader(f);
+    }
+
+    inline Catalog::HeaderT Catalog::ScanHeader(std::istream &is)
+    {
+        HeaderT header;
+        header.maxPlurals = 0;
+        // The metadata is usually shorter than a block.
+        const std::size_t blockSize = 4 * 1024;
+        std::vector<char> buffer(blockSize);
+        std::streambuf *const buf = is.rdbuf();
+        PoParser::IncrementalParser parser;
+        bool found = false;
+        // Take the errors before the first entry, and the metadata if the first entry has it.
+        auto take = [&header, &found](std::vector<PoParser::PoEntryT> entries) {
+            for (auto &it : entries) {
+                if (!it.error.empty()) {
+                    header.errors.push_back(std::move(it.error));
+                } else {
+                    if (it.msgid.empty() && !it.msgstr[0].empty()) {
+                        ParseMetadata(it.msgstr[0], header.metadata, header.pluralFunction, header.maxPlurals, header.errors);
+                    }
+                    found = true;
+                    return;
+                }
+            }
+        };
+        std::streamsize n = buf != nullptr ? buf->sgetn(buffer.data(), blockSize) : 0;
+        // The first block has the magic bytes.
+        Decompressor decompressor(Decompressor::GetFormat(buffer.data(), n > 0 ? static_cast<std::size_t>(n) : 0));
+        auto feed = [&parser, &found, &take](const char *data, std::size_t size) {
+            if (!found) {
+                take(parser.Feed(data, size));
+            }
+        };
+        while (n > 0 && !found) {
+            if (!decompressor.Feed(buffer.data(), static_cast<std::size_t>(n), feed) || found) {
+                break;
+            }
+            n = buf->sgetn(buffer.data(), blockSize);
+        }
+        if (!found) {
+            if (!decompressor.Finish()) {
+                header.errors.push_back(decompressor.GetError());
+            } else {
+                take(parser.Finish());
+            }
+        }
+        return header;
+    }
+
+    inline bool Catalog::AddFiles(const std::vector<std::string> &paths, const AddFilesOptionsT &options)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(loadProfile);
+        struct FileResultT {
+            std::vector<PoParser::PoEntryT> entries;
+            std::string error;
+            // A large file is parsed in the chunks, and it's kept until they are merged.
+            std::unique_ptr<FileBuffer> file;
+            std::unique_ptr<PoParser::ChunkedParser> chunks;
+            std::size_t nPendingChunks;
+            bool done;
+        };
+        std::vector<FileResultT> results(paths.size());
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::exception_ptr exception;
+        std::size_t nPendingTasks = 0;
+        std::atomic<bool> canceled(false);
+        const unsigned int nWorkers = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1U);
+
+        // Each worker takes a chunk of a large file, or the next file when it's free.
+        std::size_t next = 0;
+        std::size_t nOpening = 0;
+        std::deque<std::pair<std::size_t, std::size_t>> chunkTasks;
+        auto parseFile = [&](const std::size_t i) {
+            std::unique_ptr<FileBuffer> file;
+            std::unique_ptr<PoParser::ChunkedParser> chunks;
+            std::vector<PoParser::PoEntryT> entries;
+            std::string error;
+            std::exception_ptr e;
+            if (!canceled) {
+                try {
+                    file = OpenFile(paths[i]);
+                    if (file->IsOpen() && Decompressor::GetFormat(file->begin(), file->end() - file->begin()) == Decompressor::FormatT::PLAIN) {
+                        chunks.reset(new PoParser::ChunkedParser(file->begin(), file->end(), nWorkers));
+                        if (chunks->GetChunkCount() == 1) {
+                            chunks.reset();
+                        }
+                    }
+                    if (!chunks) {
+                        ReadEntries(*file, entries, error);
+                    }
+                } catch (...) {
+                    chunks.reset();
+                    e = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            --nOpening;
+            if (chunks) {
+                for (std::size_t k = 0; k < chunks->GetChunkCount(); ++k) {
+                    chunkTasks.emplace_back(i, k);
+                }
+                results[i].nPendingChunks = chunks->GetChunkCount();
+                results[i].file = std::move(file);
+                results[i].chunks = std::move(chunks);
+            } else {
+                results[i].entries = std::move(entries);
+                results[i].error = std::move(error);
+                results[i].done = true;
+            }
+            if (e && !exception) {
+                exception = e;
+            }
+            cond.notify_all();
+        };
+        auto parseChunk = [&](const std::size_t i, const std::size_t k) {
+            std::exception_ptr e;
+            if (!canceled) {
+                try {
+                    results[i].chunks->Parse(k);
+                } catch (...) {
+                    e = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--results[i].nPendingChunks == 0) {
+                results[i].done = true;
+            }
+            if (e && !exception) {
+                exception = e;
+            }
+            cond.notify_all();
+        };
+        auto work = [&]() {
+            for (;;) {
+                std::unique_lock<std::mutex> lock(mutex);
+                // A file that is being opened may add the chunks.
+                cond.wait(lock, [&]() { return canceled || !chunkTasks.empty() || next < paths.size() || nOpening == 0; });
+                if (canceled) {
+                    break;
+                }
+                if (!chunkTasks.empty()) {
+                    const std::pair<std::size_t, std::size_t> task(chunkTasks.front());
+                    chunkTasks.pop_front();
+                    lock.unlock();
+                    parseChunk(task.first, task.second);
+                } else if (next < paths.size()) {
+                    const std::size_t i = next++;
+                    ++nOpening;
+                    lock.unlock();
+                    parseFile(i);
+                } else {
+                    break;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto waitAll = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                canceled = true;
+                cond.notify_all();
+            }
+            for (auto &t : workers) {
+                t.join();
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return nPendingTasks == 0; });
+        };
+        try {
+            for (unsigned int k = 0; k < nWorkers; ++k) {
+                if (options.executor) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        ++nPendingTasks;
+                    }
+                    try {
+                        options.executor([&]() {
+                            work();
+                            std::lock_guard<std::mutex> lock(mutex);
+                            --nPendingTasks;
+                            cond.notify_all();
+                        });
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        --nPendingTasks;
+                        throw;
+                    }
+                } else {
+                    workers.emplace_back(work);
+                }
+            }
+
+            // Merge the results in the order of paths, while the rest of the files are parsed.
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return results[i].done || exception; });
+                if (exception) {
+                    break;
+                }
+                std::vector<PoParser::PoEntryT> newEntries(std::move(results[i].entries));
+                std::string error(std::move(results[i].error));
+                const std::unique_ptr<FileBuffer> file(std::move(results[i].file));
+                const std::unique_ptr<PoParser::ChunkedParser> chunks(std::move(results[i].chunks));
+                lock.unlock();
+
+                if (chunks) {
+                    newEntries = chunks->GetEntries();
+                }
+                const std::size_t prevErrorSize = errors.size();
+                AddEntries(newEntries);
+                if (!error.empty()) {
+                    errors.push_back(std::move(error));
+                }
+                for (std::size_t k = prevErrorSize; k < errors.size(); ++k) {
+                    errors[k].insert(0, paths[i] + ": ");
+                }
+            }
+        } catch (...) {
+            waitAll();
+            throw;
+        }
+        waitAll();
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return errors.empty();
+    }
+
+    inline Catalog::IncrementalAdder::IncrementalAdder(Catalog &target)
+        : catalog(target), parser()
+    {
+    }
+
+    inline bool Catalog::IncrementalAdder::Feed(const char *const data, const std::size_t size)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(catalog.loadProfile);
+        std::vector<PoParser::PoEntryT> newEntries(parser.Feed(data, size));
+        return catalog.AddEntries(newEntries);
+    }
+
+    inline bool Catalog::IncrementalAdder::Finish()
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_COLLECT(catalog.loadProfile);
+        std::vector<PoParser::PoEntryT> newEntries(parser.Finish());
+        return catalog.AddEntries(newEntries);
     }
 
     inline void Catalog::Merge(const Catalog &a)
@@ -431,6 +955,18 @@ namespace spiritless_po {
         statistics = Catalog::StatisticsT{};
     }
 
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+    inline const Catalog::LoadProfileT &Catalog::GetLoadProfile() const noexcept
+    {
+        return loadProfile;
+    }
+
+    inline void Catalog::ClearLoadProfile() noexcept
+    {
+        loadProfile = LoadProfileT();
+    }
+#endif
+
     inline const MetadataParser::MapT &Catalog::GetMetadata() const noexcept
     {
         return metadata;
@@ -0,0 +1,255 @@
+/** Decompressor of the compressed text.
+    \file Decompressor.h
+    \author OOTA, Masato
+    \copyright Copyright © 2026 OOTA, Masato
+    \par License Boost
+    \parblock
+      This program is distributed under the Boost Software License Version 1.0.
+      You can get the license file at “https://www.boost.org/LICENSE_1_0.txt”.
+    \endparblock
+
+    gzip is supported if SPIRITLESS_PO_USE_ZLIB is defined, and zstd is supported if SPIRITLESS_PO_USE_ZSTD is defined.
+    The program needs to link zlib and/or libzstd in that case.
+*/
+
+#ifndef SPIRITLESS_PO_DECOMPRESSOR_H_
+#define SPIRITLESS_PO_DECOMPRESSOR_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef SPIRITLESS_PO_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace spiritless_po {
+    /** This class decompresses the text that is given in chunks.
+
+        The decompressed text is passed to a sink by the blocks, so the whole decompressed text isn't held in the memory.
+    */
+    class Decompressor {
+    public:
+        /** Type of the compression format. */
+        enum class FormatT {
+            PLAIN, /**< Not compressed. */
+            GZIP, /**< gzip. */
+            ZSTD, /**< Zstandard. */
+        };
+
+        /** Detect the compression format by the magic bytes.
+            \param [in] data The pointer to the beginning of the text.
+            \param [in] size The size of the text.
+            \return The compression format, or FormatT::PLAIN if the magic bytes are unknown.
+        */
+        static FormatT GetFormat(const char *data, std::size_t size) noexcept;
+
+        /** Create a decompressor.
+            \param [in] format The compression format of the text.
+            \note GetError() isn't empty if the format isn't supported.
+        */
+        explicit Decompressor(FormatT format);
+
+        /** This class is uncopyable. */
+        Decompressor(const Decompressor &) = delete;
+
+        /** This class is unassignable. */
+        Decompressor &operator=(const Decompressor &) = delete;
+
+        /** Release the resources. */
+        ~Decompressor();
+
+        /** Decompress a chunk.
+            \tparam Sink A type of a function that is called as sink(const char *data, std::size_t size).
+            \param [in] data The pointer to the chunk.
+            \param [in] size The size of the chunk.
+            \param [in] sink The function that receives the decompressed text.
+            \return true if no error is existed.
+        */
+        template <typename Sink>
+        bool Feed(const char *data, std::size_t size, Sink &&sink);
+
+        /** Check the end of the compressed text.
+            \return true if no error is existed and the compressed text is complete.
+        */
+        bool Finish();
+
+        /** Get the error information.
+            \return The string that describes the error, or an empty string if no error is occurred.
+        */
+        const std::string &GetError() const noexcept;
+
+    private:
+        // The decompressed text is passed to the sink by this size.
+        static constexpr std::size_t outBufferSize = 64 * 1024;
+
+        FormatT format;
+        std::string error;
+        // The stream has been finished, and the next data is the next stream.
+        bool isStreamEnd;
+        std::vector<char> outBuffer;
+#ifdef SPIRITLESS_PO_USE_ZLIB
+        z_stream zs;
+        bool zsInitialized;
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+        ZSTD_DStream *zds;
+#endif
+    };
+
+    inline Decompressor::FormatT Decompressor::GetFormat(const char *const data, const std::size_t size) noexcept
+    {
+        if (size >= 2 && std::memcmp(data, "\x1F\x8B", 2) == 0) {
+            return FormatT::GZIP;
+        }
+        if (size >= 4 && std::memcmp(data, "\x28\xB5\x2F\xFD", 4) == 0) {
+            return FormatT::ZSTD;
+        }
+        return FormatT::PLAIN;
+    }
+
+    inline Decompressor::Decompressor(const FormatT format)
+        : format(format), error(), isStreamEnd(true), outBuffer()
+#ifdef SPIRITLESS_PO_USE_ZLIB
+        , zs(), zsInitialized(false)
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+        , zds(nullptr)
+#endif
+    {
+        switch (format) {
+        case FormatT::GZIP:
+#ifdef SPIRITLESS_PO_USE_ZLIB
+            // 16 + MAX_WBITS: Accept only the gzip header.
+            if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+                error = "gzip: Can't initialize the decompressor.";
+            } else {
+                zsInitialized = true;
+                outBuffer.resize(outBufferSize);
+            }
+#else
+            error = "gzip is not supported.";
+#endif
+            break;
+        case FormatT::ZSTD:
+#ifdef SPIRITLESS_PO_USE_ZSTD
+            zds = ZSTD_createDStream();
+            if (zds == nullptr || ZSTD_isError(ZSTD_initDStream(zds))) {
+                error = "zstd: Can't initialize the decompressor.";
+            } else {
+                outBuffer.resize(outBufferSize);
+            }
+#else
+            error = "zstd is not supported.";
+#endif
+            break;
+        default:
+            break;
+        }
+    }
+
+    inline Decompressor::~Decompressor()
+    {
+#ifdef SPIRITLESS_PO_USE_ZLIB
+        if (zsInitialized) {
+            inflateEnd(&zs);
+        }
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+        ZSTD_freeDStream(zds);
+#endif
+    }
+
+    template <typename Sink>
+    bool Decompressor::Feed(const char *const data, const std::size_t size, Sink &&sink)
+    {
+        if (!error.empty()) {
+            return false;
+        }
+        switch (format) {
+        case FormatT::GZIP: {
+#ifdef SPIRITLESS_PO_USE_ZLIB
+            const char *p = data;
+            std::size_t rest = size;
+            // zlib takes the size as uInt.
+            const std::size_t maxInput = 1024 * 1024 * 1024;
+            // The output buffer is full, and inflate() may have more output.
+            bool isOutputFull = false;
+            while (rest > 0 || zs.avail_in > 0 || isOutputFull) {
+                if (zs.avail_in == 0) {
+                    const std::size_t n = rest < maxInput ? rest : maxInput;
+                    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(p));
+                    zs.avail_in = static_cast<uInt>(n);
+                    p += n;
+                    rest -= n;
+                }
+                if (isStreamEnd) {
+                    // A gzip file may contain some members.
+                    inflateReset(&zs);
+                    isStreamEnd = false;
+                }
+                zs.next_out = reinterpret_cast<Bytef *>(outBuffer.data());
+                zs.avail_out = static_cast<uInt>(outBuffer.size());
+                const int result = inflate(&zs, Z_NO_FLUSH);
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                    error = std::string("gzip: ") + (zs.msg != nullptr ? zs.msg : "Invalid compressed data.");
+                    return false;
+                }
+                const std::size_t outSize = outBuffer.size() - zs.avail_out;
+                if (outSize > 0) {
+                    sink(static_cast<const char *>(outBuffer.data()), outSize);
+                }
+                isStreamEnd = result == Z_STREAM_END;
+                isOutputFull = zs.avail_out == 0 && !isStreamEnd;
+            }
+#endif
+            break;
+        }
+        case FormatT::ZSTD: {
+#ifdef SPIRITLESS_PO_USE_ZSTD
+            ZSTD_inBuffer in = { data, size, 0 };
+            // The output buffer is full, and ZSTD_decompressStream() may have more output.
+            bool isOutputFull = false;
+            while (in.pos < in.size || isOutputFull) {
+                ZSTD_outBuffer out = { outBuffer.data(), outBuffer.size(), 0 };
+                const std::size_t result = ZSTD_decompressStream(zds, &out, &in);
+                if (ZSTD_isError(result)) {
+                    error = std::string("zstd: ") + ZSTD_getErrorName(result);
+                    return false;
+                }
+                if (out.pos > 0) {
+                    sink(static_cast<const char *>(outBuffer.data()), out.pos);
+                }
+                // 0 means that a frame has been finished.
+                isStreamEnd = result == 0;
+                isOutputFull = out.pos == out.size;
+            }
+#endif
+            break;
+        }
+        default:
+            sink(data, size);
+            break;
+        }
+        return true;
+    }
+
+    inline bool Decompressor::Finish()
+    {
+        if (error.empty() && !isStreamEnd) {
+            error = format == FormatT::GZIP ? "gzip: Unexpected end of the compressed data." : "zstd: Unexpected end of the compressed data.";
+        }
+        return error.empty();
+    }
+
+    inline const std::string &Decompressor::GetError() const noexcept
+    {
+        return error;
+    }
+} // namespace spiritless_po
+
+#endif // SPIRITLESS_PO_DECOMPRESSOR_H_
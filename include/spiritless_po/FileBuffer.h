@@ -0,0 +1,186 @@
+/** File contents in the memory.
+    \file FileBuffer.h
+    \author OOTA, Masato
+    \copyright Copyright © 2026 OOTA, Masato
+    \par License Boost
+    \parblock
+      This program is distributed under the Boost Software License Version 1.0.
+      You can get the license file at “https://www.boost.org/LICENSE_1_0.txt”.
+    \endparblock
+*/
+
+#ifndef SPIRITLESS_PO_FILE_BUFFER_H_
+#define SPIRITLESS_PO_FILE_BUFFER_H_
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPIRITLESS_PO_FILE_BUFFER_USE_MMAP
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace spiritless_po {
+    /** This class holds the contents of a file in the memory.
+
+        A regular file is mapped into the memory if the platform supports mmap(), and the other files, such as pipes, are read by the large blocks.
+    */
+    class FileBuffer {
+    public:
+        /** Read a file.
+            \param [in] path The path of the file.
+            \note IsOpen() returns false if the file cannot be read.
+        */
+        explicit FileBuffer(const char *path);
+
+        /** This class is uncopyable. */
+        FileBuffer(const FileBuffer &) = delete;
+
+        /** This class is unassignable. */
+        FileBuffer &operator=(const FileBuffer &) = delete;
+
+        /** Release the contents. */
+        ~FileBuffer();
+
+        /** Check if the file has been read.
+            \return true if the file has been read.
+        */
+        bool IsOpen() const noexcept;
+
+        /** Get the beginning of the contents.
+            \return The pointer to the beginning of the contents.
+        */
+        const char *begin() const noexcept;
+
+        /** Get the end of the contents.
+            \return The pointer to the end of the contents.
+        */
+        const char *end() const noexcept;
+
+    private:
+#ifdef SPIRITLESS_PO_FILE_BUFFER_USE_MMAP
+        bool ReadAll(int fd);
+#endif
+
+        const char *data;
+        std::size_t size;
+        bool opened;
+        bool mapped;
+        std::vector<char> buffer;
+    };
+
+#ifdef SPIRITLESS_PO_FILE_BUFFER_USE_MMAP
+    inline FileBuffer::FileBuffer(const char *const path)
+        : data(nullptr), size(0), opened(false), mapped(false), buffer()
+    {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+#ifdef POSIX_FADV_SEQUENTIAL
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            void *const p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+                ::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+                data = static_cast<const char *>(p);
+                size = static_cast<std::size_t>(st.st_size);
+                opened = true;
+                mapped = true;
+            }
+        }
+        if (!mapped) {
+            // Pipes, special files, and the files that cannot be mapped.
+            opened = ReadAll(fd);
+        }
+        ::close(fd);
+    }
+
+    inline FileBuffer::~FileBuffer()
+    {
+        if (mapped) {
+            ::munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    // Read the file until the end by the large blocks.
+    inline bool FileBuffer::ReadAll(const int fd)
+    {
+        const std::size_t blockSize = 64 * 1024;
+        std::size_t len = 0;
+        for (;;) {
+            buffer.resize(len + blockSize);
+            const ssize_t n = ::read(fd, buffer.data() + len, blockSize);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                buffer.clear();
+                return false;
+            }
+            if (n == 0) {
+                break;
+            }
+            len += static_cast<std::size_t>(n);
+        }
+        buffer.resize(len);
+        data = buffer.data();
+        size = len;
+        return true;
+    }
+#else
+    inline FileBuffer::FileBuffer(const char *const path)
+        : data(nullptr), size(0), opened(false), mapped(false), buffer()
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            return;
+        }
+        const std::size_t blockSize = 64 * 1024;
+        std::size_t len = 0;
+        for (;;) {
+            buffer.resize(len + blockSize);
+            const std::streamsize n = f.rdbuf()->sgetn(buffer.data() + len, blockSize);
+            if (n <= 0) {
+                break;
+            }
+            len += static_cast<std::size_t>(n);
+        }
+        buffer.resize(len);
+        data = buffer.data();
+        size = len;
+        opened = true;
+    }
+
+    inline FileBuffer::~FileBuffer()
+    {
+    }
+#endif // SPIRITLESS_PO_FILE_BUFFER_USE_MMAP
+
+    inline bool FileBuffer::IsOpen() const noexcept
+    {
+        return opened;
+    }
+
+    inline const char *FileBuffer::begin() const noexcept
+    {
+        return data;
+    }
+
+    inline const char *FileBuffer::end() const noexcept
+    {
+        return data + size;
+    }
+} // namespace spiritless_po
+
+#endif // SPIRITLESS_PO_FILE_BUFFER_H_
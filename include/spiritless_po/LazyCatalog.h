@@ -0,0 +1,348 @@
+/** class LazyCatalog
+    \file LazyCatalog.h
+    \author OOTA, Masato
+    \copyright Copyright © 2026 OOTA, Masato
+    \par License Boost
+    \parblock
+      This program is distributed under the Boost Software License Version 1.0.
+      You can get the license file at “https://www.boost.org/LICENSE_1_0.txt”.
+    \endparblock
+*/
+
+#ifndef SPIRITLESS_PO_LAZY_CATALOG_H_
+#define SPIRITLESS_PO_LAZY_CATALOG_H_
+
+#include "Catalog.h"
+#include "Common.h"
+#include "Decompressor.h"
+#include "FileBuffer.h"
+#include "MetadataParser.h"
+#include "PluralParser.h"
+#include "PoParser.h"
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace spiritless_po {
+    /** Class LazyCatalog handles a catalog whose translated texts are decoded when they are used first.
+
+        The loading functions check all the entries, and keep only msgid and the location of msgstr in the source text, so the loading is faster and the catalog uses less memory than Catalog if the program uses a small part of the messages.
+
+        This class has the same features as Catalog, except for:
+        - The source texts are kept in the catalog while the catalog is alive. A regular file is mapped into the memory.
+        - The catalog is uncopyable, and can't be merged.
+
+        \note The functions to get the translated text can be called on some threads at the same time, because msgstr of each entry is decoded only once under std::call_once().
+    */
+    class LazyCatalog {
+    public:
+        /** Create an empty catalog. */
+        LazyCatalog();
+
+        /** This class is uncopyable. */
+        LazyCatalog(const LazyCatalog &) = delete;
+
+        /** This class is movable.
+            \param [in] a The source.
+        */
+        LazyCatalog(LazyCatalog &&a) = default;
+
+        /** This class is destructible. */
+        ~LazyCatalog() = default;
+
+        /** This class is unassignable. */
+        LazyCatalog &operator=(const LazyCatalog &) = delete;
+
+        /** This class is move assignable.
+            \param [in] a The source.
+        */
+        LazyCatalog &operator=(LazyCatalog &&a) = default;
+
+        /** Clear all information and create an empty catalog. */
+        void Clear();
+
+        /** Add PO entries.
+            \param [in] text The text that contains PO entries. It's kept in the catalog.
+            \return true if no error is existed.
+            \note This function doesn't change any existed entries, that is a translated text (msgstr) that corresponds to an existed original text (msgid), and also metadata if it's already existed.
+            \note An entry isn't added if the msgstr (including msgstr[0]) is empty.
+        */
+        bool Add(std::string text);
+
+        /** Add PO entries from a file.
+            \param [in] path The path of the PO file.
+            \return true if no error is existed.
+            \note A regular file is mapped into the memory while the catalog is alive.
+            \note A gzip or zstd compressed file is decompressed into the memory at once. (See Decompressor.h)
+            \note This function doesn't change any existed entries, that is a translated text (msgstr) that corresponds to an existed original text (msgid), and also metadata if it's already existed.
+            \note An entry isn't added if the msgstr (including msgstr[0]) is empty.
+        */
+        bool AddFile(const char *path);
+
+        /** Clear the error information. */
+        void ClearError();
+
+        /** Get the error information generated by Add() after ClearError() is called.
+            \return The strings that describe the errors.
+            \note The size of the result is 0 if no error is occurred.
+        */
+        const std::vector<std::string> &GetError() const noexcept;
+
+        /** Get the translated text.
+            \param [in] msgid The original text.
+            \return The translated text if exists. If not, returns msgid. (It's a reference to the same object.)
+        */
+        const std::string &gettext(const std::string &msgid) const;
+
+        /** Get the translated text.
+            \param [in] msgid The original text.
+            \param [in] msgidPlural The plural form of the original text.
+            \param [in] n The value relating to the text.
+            \return The translated text if exists. If not, returns msgid (if n == 1) or msgidPlural (if n != 1). (It's a reference to the same object.)
+        */
+        const std::string &ngettext(const std::string &msgid, const std::string &msgidPlural,
+            unsigned long int n) const;
+
+        /** Get the translated text.
+            \param [in] msgctxt The context of the text.
+            \param [in] msgid The original text.
+            \return The translated text if exists. If not, returns msgid. (It's the reference to the same object.)
+        */
+        const std::string &pgettext(const std::string &msgctxt, const std::string &msgid) const;
+
+        /** Get the translated text.
+            \param [in] msgctxt The context of the text.
+            \param [in] msgid The original text.
+            \param [in] msgidPlural The plural form of the original text.
+            \param [in] n The value relating to the text.
+            \return The translated text if exists. If not, returns msgid (if n == 1) or msgidPlural (if n != 1). (It's a reference to the same object.)
+        */
+        const std::string &npgettext(const std::string &msgctxt, const std::string &msgid,
+            const std::string &msgidPlural, unsigned long int n) const;
+
+        /** Get the statistics of the messages added by Add() and AddFile().
+            \return The statistics. (See Catalog::StatisticsT)
+         */
+        const Catalog::StatisticsT &GetStatistics() const noexcept;
+
+        /** Clear the statistics of the messages added by Add() and AddFile().
+         */
+        void ClearStatistics() noexcept;
+
+        /** Get the metadata.
+            \return The map of the metadata.
+         */
+        const MetadataParser::MapT &GetMetadata() const noexcept;
+
+    private:
+        // An entry whose msgstr is decoded when it's used first.
+        struct EntryT {
+            EntryT(const char *begin, const char *end);
+
+            const char *msgstrBegin;
+            const char *msgstrEnd;
+            mutable std::once_flag decoded;
+            mutable std::vector<std::string> msgstr;
+        };
+
+        bool AddEntries(const char *begin, const char *end);
+        const std::vector<std::string> &GetMsgstr(const EntryT &entry) const;
+        const std::string *Find(const std::string &id, unsigned long int n, bool isPlural) const;
+
+        // The source texts. The elements don't move when a new element is added.
+        std::deque<FileBuffer> files;
+        std::deque<std::string> texts;
+        MetadataParser::MapT metadata;
+        std::unordered_map<std::string, std::size_t> index;
+        std::deque<EntryT> entries;
+        PluralParser::FunctionType pluralFunction;
+        std::size_t maxPlurals;
+        std::vector<std::string> errors;
+        Catalog::StatisticsT statistics;
+    };
+
+    inline LazyCatalog::EntryT::EntryT(const char *const begin, const char *const end)
+        : msgstrBegin(begin), msgstrEnd(end), decoded(), msgstr()
+    {
+    }
+
+    inline LazyCatalog::LazyCatalog()
+        : files(), texts(), metadata(), index(), entries(), pluralFunction(),
+          maxPlurals(0), errors(), statistics{}
+    {
+    }
+
+    inline void LazyCatalog::Clear()
+    {
+        *this = LazyCatalog();
+    }
+
+    inline bool LazyCatalog::Add(std::string text)
+    {
+        texts.push_back(std::move(text));
+        const std::string &s = texts.back();
+        return AddEntries(s.data(), s.data() + s.size());
+    }
+
+    inline bool LazyCatalog::AddFile(const char *const path)
+    {
+        files.emplace_back(path);
+        const FileBuffer &file = files.back();
+        if (!file.IsOpen()) {
+            files.pop_back();
+            errors.emplace_back("Can't open the file.");
+            return false;
+        }
+        const Decompressor::FormatT format = Decompressor::GetFormat(file.begin(), file.end() - file.begin());
+        if (format == Decompressor::FormatT::PLAIN) {
+            return AddEntries(file.begin(), file.end());
+        }
+
+        // msgstr refers to the decompressed text.
+        std::string text;
+        Decompressor decompressor(format);
+        decompressor.Feed(file.begin(), file.end() - file.begin(), [&text](const char *data, std::size_t size) {
+            text.append(data, size);
+        });
+        files.pop_back();
+        const bool finished = decompressor.Finish();
+        Add(std::move(text));
+        if (!finished) {
+            errors.push_back(decompressor.GetError());
+        }
+        return errors.empty();
+    }
+
+    // Index the entries in the text that is kept in the catalog.
+    inline bool LazyCatalog::AddEntries(const char *const begin, const char *const end)
+    {
+        std::vector<PoParser::IndexEntryT> newEntries(PoParser::GetIndexEntries(begin, end));
+        statistics.totalCount += newEntries.size();
+        const size_t prevIndexSize = index.size();
+        for (auto &it : newEntries) {
+            if (!it.error.empty()) {
+                errors.push_back(std::move(it.error));
+                statistics.totalCount--;
+            } else if (!it.isMsgstr0Empty) {
+                if (it.msgid.empty()) {
+                    statistics.metadataCount++;
+                    if (metadata.empty()) {
+                        const std::vector<std::string> msgstr(PoParser::DecodeMsgstr(it.msgstrBegin, it.msgstrEnd));
+                        Catalog::ParseMetadata(msgstr[0], metadata, pluralFunction, maxPlurals, errors);
+                    }
+                }
+                if (index.emplace(std::move(it.msgid), entries.size()).second) {
+                    entries.emplace_back(it.msgstrBegin, it.msgstrEnd);
+                } else {
+                    statistics.discardedCount++;
+                }
+            }
+        }
+        statistics.translatedCount += index.size() - prevIndexSize;
+        return errors.empty();
+    }
+
+    // Decode msgstr of the entry if it's not decoded yet.
+    inline const std::vector<std::string> &LazyCatalog::GetMsgstr(const EntryT &entry) const
+    {
+        std::call_once(entry.decoded, [&entry]() {
+            entry.msgstr = PoParser::DecodeMsgstr(entry.msgstrBegin, entry.msgstrEnd);
+        });
+        return entry.msgstr;
+    }
+
+    // Find the translated text of id.
+    // Return nullptr if it's not found.
+    inline const std::string *LazyCatalog::Find(const std::string &id, const unsigned long int n, const bool isPlural) const
+    {
+        const auto &it = index.find(id);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        const std::vector<std::string> &msgstr = GetMsgstr(entries[it->second]);
+        std::size_t nIdx = 0;
+        if (isPlural) {
+            nIdx = pluralFunction(n);
+            if (nIdx > maxPlurals || nIdx >= msgstr.size()) {
+                nIdx = 0;
+            }
+        }
+        return &msgstr[nIdx];
+    }
+
+    inline void LazyCatalog::ClearError()
+    {
+        errors.clear();
+    }
+
+    inline const std::vector<std::string> &LazyCatalog::GetError() const noexcept
+    {
+        return errors;
+    }
+
+    inline const std::string &LazyCatalog::gettext(const std::string &msgid) const
+    {
+        const std::string *const s = Find(msgid, 1, false);
+        return s != nullptr ? *s : msgid;
+    }
+
+    inline const std::string &LazyCatalog::ngettext(const std::string &msgid, const std::string &msgidPlural,
+        unsigned long int n) const
+    {
+        const std::string *const s = Find(msgid, n, true);
+        if (s != nullptr) {
+            return *s;
+        } else if (n == 1) {
+            return msgid;
+        } else {
+            return msgidPlural;
+        }
+    }
+
+    inline const std::string &LazyCatalog::pgettext(const std::string &msgctxt, const std::string &msgid) const
+    {
+        std::string id(msgctxt);
+        id += CONTEXT_SEPARATOR;
+        id += msgid;
+        const std::string *const s = Find(id, 1, false);
+        return s != nullptr ? *s : msgid;
+    }
+
+    inline const std::string &LazyCatalog::npgettext(const std::string &msgctxt, const std::string &msgid,
+        const std::string &msgidPlural, unsigned long int n) const
+    {
+        std::string id(msgctxt);
+        id += CONTEXT_SEPARATOR;
+        id += msgid;
+        const std::string *const s = Find(id, n, true);
+        if (s != nullptr) {
+            return *s;
+        } else if (n == 1) {
+            return msgid;
+        } else {
+            return msgidPlural;
+        }
+    }
+
+    inline const Catalog::StatisticsT &LazyCatalog::GetStatistics() const noexcept
+    {
+        return statistics;
+    }
+
+    inline void LazyCatalog::ClearStatistics() noexcept
+    {
+        statistics = Catalog::StatisticsT{};
+    }
+
+    inline const MetadataParser::MapT &LazyCatalog::GetMetadata() const noexcept
+    {
+        return metadata;
+    }
+} // namespace spiritless_po
+
+#endif // SPIRITLESS_PO_LAZY_CATALOG_H_
@@ -0,0 +1,219 @@
+/** Profile of the loading phases.
+    \file LoadProfile.h
+    \author OOTA, Masato
+    \copyright Copyright © 2026 OOTA, Masato
+    \par License Boost
+    \parblock
+      This program is distributed under the Boost Software License Version 1.0.
+      You can get the license file at “https://www.boost.org/LICENSE_1_0.txt”.
+    \endparblock
+
+    The profile is compiled in only if SPIRITLESS_PO_DEBUG_LOAD_PROFILE is defined. Otherwise, the macros in this file are empty, and the loading has no overhead.
+    \attention All the translation units in a program must be compiled with the same definition of SPIRITLESS_PO_DEBUG_LOAD_PROFILE, because it changes the members of Catalog.
+*/
+
+#ifndef SPIRITLESS_PO_LOAD_PROFILE_H_
+#define SPIRITLESS_PO_LOAD_PROFILE_H_
+
+#ifdef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace spiritless_po {
+    /** Type of the profile of the loading.
+
+        The time of each phase doesn't include the time of the other phases that are nested in it, so the sum of the phases, except for hash, is the time that is profiled.
+        \note The timers add some overhead to each token, so the proportions of the phases are more useful than the absolute times.
+    */
+    struct LoadProfileT {
+        /** Type of the counters of a phase. */
+        struct PhaseT {
+            std::uint64_t nanoseconds; /**< The time of the phase. */
+            std::uint64_t bytes; /**< The bytes processed by the phase. */
+            std::uint64_t count; /**< The number of the items processed by the phase. */
+        };
+
+        PhaseT total; /**< The whole loading functions. count is the number of the calls. The time includes the phases and the rest of the work. */
+        PhaseT read; /**< Reading the stream or mapping the file. bytes is the read size. */
+        PhaseT decompress; /**< Decompressing the text. bytes is the decompressed size. */
+        PhaseT lex; /**< Lexing the tokens, except for ParseText. bytes is the size of the parsed text in the memory, and count is the number of the tokens. */
+        PhaseT parseText; /**< Unescaping the quoted texts. bytes is the size of the unescaped texts, and count is the number of the texts. */
+        PhaseT assemble; /**< Assembling the entries from the tokens. count is the number of the entries. */
+        PhaseT hash; /**< Hashing msgid. It's measured separately, and it's also included in index. bytes is the size of msgid. */
+        PhaseT index; /**< Inserting the entries into the index and the string table. count is the number of the insertions, including the discarded entries. */
+        PhaseT metadata; /**< Parsing the metadata and compiling the plural expression. bytes is the size of the metadata. */
+
+        /** Add the counters.
+            \param [in] a The profile to add.
+            \return *this.
+        */
+        LoadProfileT &operator+=(const LoadProfileT &a) noexcept;
+
+        /** Subtract the counters.
+            \param [in] a The profile to subtract.
+            \return *this.
+        */
+        LoadProfileT &operator-=(const LoadProfileT &a) noexcept;
+    };
+
+    /** This class accumulates the profile of the current thread. */
+    class LoadProfiler {
+    public:
+        /** Get the profile of the current thread.
+            \return The profile.
+        */
+        static LoadProfileT &GetThreadProfile() noexcept;
+
+        /** This class adds the time of a scope to a phase, except for the time of the nested scopes. */
+        class Timer {
+        public:
+            /** Start the timer.
+                \param [in] phase The phase to add the time.
+            */
+            explicit Timer(LoadProfileT::PhaseT &phase) noexcept;
+
+            Timer(const Timer &) = delete;
+            Timer &operator=(const Timer &) = delete;
+
+            /** Stop the timer, and add the time. */
+            ~Timer();
+
+            /** Stop the timer before the end of the scope, and add the time. */
+            void Stop() noexcept;
+
+        private:
+            static Timer *&Current() noexcept;
+
+            LoadProfileT::PhaseT &phase;
+            Timer *parent;
+            std::uint64_t nested;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        /** This class adds the profile of the current thread in a scope to a target, unless the scope is nested in another Collector. */
+        class Collector {
+        public:
+            /** Start collecting.
+                \param [in] target The profile to add.
+            */
+            explicit Collector(LoadProfileT &target) noexcept;
+
+            Collector(const Collector &) = delete;
+            Collector &operator=(const Collector &) = delete;
+
+            /** Add the profile in the scope to the target. */
+            ~Collector();
+
+        private:
+            static unsigned int &Depth() noexcept;
+
+            LoadProfileT &target;
+            LoadProfileT start;
+            std::chrono::steady_clock::time_point startTime;
+        };
+    };
+
+    inline LoadProfileT &LoadProfileT::operator+=(const LoadProfileT &a) noexcept
+    {
+        PhaseT *const dst[] = { &total, &read, &decompress, &lex, &parseText, &assemble, &hash, &index, &metadata };
+        const PhaseT *const src[] = { &a.total, &a.read, &a.decompress, &a.lex, &a.parseText, &a.assemble, &a.hash, &a.index, &a.metadata };
+        for (std::size_t i = 0; i < sizeof(dst) / sizeof(dst[0]); ++i) {
+            dst[i]->nanoseconds += src[i]->nanoseconds;
+            dst[i]->bytes += src[i]->bytes;
+            dst[i]->count += src[i]->count;
+        }
+        return *this;
+    }
+
+    inline LoadProfileT &LoadProfileT::operator-=(const LoadProfileT &a) noexcept
+    {
+        PhaseT *const dst[] = { &total, &read, &decompress, &lex, &parseText, &assemble, &hash, &index, &metadata };
+        const PhaseT *const src[] = { &a.total, &a.read, &a.decompress, &a.lex, &a.parseText, &a.assemble, &a.hash, &a.index, &a.metadata };
+        for (std::size_t i = 0; i < sizeof(dst) / sizeof(dst[0]); ++i) {
+            dst[i]->nanoseconds -= src[i]->nanoseconds;
+            dst[i]->bytes -= src[i]->bytes;
+            dst[i]->count -= src[i]->count;
+        }
+        return *this;
+    }
+
+    inline LoadProfileT &LoadProfiler::GetThreadProfile() noexcept
+    {
+        thread_local LoadProfileT profile{};
+        return profile;
+    }
+
+    inline LoadProfiler::Timer::Timer(LoadProfileT::PhaseT &phase) noexcept
+        : phase(phase), parent(Current()), nested(0), start(std::chrono::steady_clock::now())
+    {
+        Current() = this;
+    }
+
+    inline LoadProfiler::Timer::~Timer()
+    {
+        Stop();
+    }
+
+    inline void LoadProfiler::Timer::Stop() noexcept
+    {
+        if (Current() != this) {
+            // It has been stopped.
+            return;
+        }
+        const std::uint64_t elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        phase.nanoseconds += elapsed > nested ? elapsed - nested : 0;
+        if (parent != nullptr) {
+            parent->nested += elapsed;
+        }
+        Current() = parent;
+    }
+
+    inline LoadProfiler::Timer *&LoadProfiler::Timer::Current() noexcept
+    {
+        thread_local Timer *current = nullptr;
+        return current;
+    }
+
+    inline LoadProfiler::Collector::Collector(LoadProfileT &target) noexcept
+        : target(target), start(GetThreadProfile()), startTime(std::chrono::steady_clock::now())
+    {
+        ++Depth();
+    }
+
+    inline LoadProfiler::Collector::~Collector()
+    {
+        if (--Depth() == 0) {
+            LoadProfileT &profile = GetThreadProfile();
+            profile.total.nanoseconds += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+            ++profile.total.count;
+            LoadProfileT diff(profile);
+            diff -= start;
+            target += diff;
+        }
+    }
+
+    inline unsigned int &LoadProfiler::Collector::Depth() noexcept
+    {
+        thread_local unsigned int depth = 0;
+        return depth;
+    }
+} // namespace spiritless_po
+
+/** Add the time of the scope to a phase of the thread profile. */
+#define SPIRITLESS_PO_LOAD_PROFILE_TIMER(phase) ::spiritless_po::LoadProfiler::Timer spiritless_po_load_profile_timer_(::spiritless_po::LoadProfiler::GetThreadProfile().phase)
+/** Add the bytes and the count to a phase of the thread profile. */
+#define SPIRITLESS_PO_LOAD_PROFILE_COUNT(phase, nBytes, nCount) (::spiritless_po::LoadProfiler::GetThreadProfile().phase.bytes += (nBytes), ::spiritless_po::LoadProfiler::GetThreadProfile().phase.count += (nCount))
+/** Add the profile of the thread in the scope to a target. */
+#define SPIRITLESS_PO_LOAD_PROFILE_COLLECT(target) ::spiritless_po::LoadProfiler::Collector spiritless_po_load_profile_collector_(target)
+
+#else
+
+#define SPIRITLESS_PO_LOAD_PROFILE_TIMER(phase)
+#define SPIRITLESS_PO_LOAD_PROFILE_COUNT(phase, nBytes, nCount) ((void)0)
+#define SPIRITLESS_PO_LOAD_PROFILE_COLLECT(target)
+
+#endif // SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+
+#endif // SPIRITLESS_PO_LOAD_PROFILE_H_
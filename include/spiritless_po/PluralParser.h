@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <limits>
@@ -21,6 +22,7 @@
 #include <stdexcept>
 #include <string>
 #include <map>
+#include <utility>
 #include <vector>
 
 #if (defined(SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT_EXECUTE) || defined(SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT_COMPILE)) && !defined(SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT)
@@ -135,12 +137,54 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
             explicit FunctionType(CompiledPluralFunctionT func);
 
             static std::uint_fast32_t Equivalent32bitUint(NumT n);
-            std::uint_fast32_t Read32(size_t &i) const;
+
+            // Operation of the pre-decoded program.
+            typedef unsigned char OperationT;
+            // The instruction of the pre-decoded program.
+            struct InstructionT {
+                OperationT op;
+                unsigned char reg; // The register.
+                std::uint_fast32_t operand; // The immediate number, or the index of the jump target.
+            };
+            // The compiler from the bytecode to the instructions.
+            class Compiler;
+
+            void Verify();
+            void CreateTable(std::uint_fast32_t bound, std::uint_fast32_t period);
+            std::uint_fast32_t Execute(std::uint_fast32_t n32, std::uint_fast32_t *stack) const;
+
+            // for debug
+            static void DebugPrintInstruction(const InstructionT &inst);
+            void DebugPrintProgram() const;
+
+            /* for interpreter */
+            // OP_x_NUM has the immediate number as the right operand, and OP_VAR_x_NUM and OP_REG_x_NUM also have n and the register as the left operand.
+            // The order of OP_MULT..OP_OR is the same as MULT..OR in the four groups.
+            enum : OperationT {
+                OP_PUSH_NUM, OP_PUSH_VAR, OP_PUSH_REG, OP_NOT, OP_BOOL,
+                OP_MULT, OP_DIV, OP_MOD, OP_ADD, OP_SUB, OP_LE, OP_LT, OP_GT, OP_GE, OP_EQ, OP_NE, OP_AND, OP_OR,
+                OP_MULT_NUM, OP_DIV_NUM, OP_MOD_NUM, OP_ADD_NUM, OP_SUB_NUM, OP_LE_NUM, OP_LT_NUM, OP_GT_NUM, OP_GE_NUM, OP_EQ_NUM, OP_NE_NUM, OP_AND_NUM, OP_OR_NUM,
+                OP_VAR_MULT_NUM, OP_VAR_DIV_NUM, OP_VAR_MOD_NUM, OP_VAR_ADD_NUM, OP_VAR_SUB_NUM, OP_VAR_LE_NUM, OP_VAR_LT_NUM, OP_VAR_GT_NUM, OP_VAR_GE_NUM, OP_VAR_EQ_NUM, OP_VAR_NE_NUM, OP_VAR_AND_NUM, OP_VAR_OR_NUM,
+                OP_REG_MULT_NUM, OP_REG_DIV_NUM, OP_REG_MOD_NUM, OP_REG_ADD_NUM, OP_REG_SUB_NUM, OP_REG_LE_NUM, OP_REG_LT_NUM, OP_REG_GT_NUM, OP_REG_GE_NUM, OP_REG_EQ_NUM, OP_REG_NE_NUM, OP_REG_AND_NUM, OP_REG_OR_NUM,
+                OP_SET_REG_VAR_MOD_NUM, OP_JUMP_IF_FALSE, OP_JUMP_IF_TRUE, OP_JUMP, OP_RETURN,
+            };
+            // The stack on the call stack is used if the program needs no more than this.
+            static constexpr std::size_t LOCAL_STACK_SIZE = 16;
+            // The registers keep n % k that is used more than once.
+            static constexpr std::size_t MAX_REGISTERS = 4;
+            // The maximum size of the lookup table.
+            static constexpr std::size_t MAX_TABLE_SIZE = 2048;
+            // The minimum size of the direct part of the lookup table.
+            static constexpr std::size_t MIN_TABLE_DIRECT_SIZE = 256;
 
         private:
             CompiledPluralFunctionT compiled_func;
-            std::vector<PluralParser::Opcode> code;
-            mutable std::vector<std::uint_fast32_t> data;
+            std::vector<InstructionT> program;
+            std::size_t stack_size;
+            // The results for n < table_bound, and the results for n >= table_bound indexed by table_bound + n % table_period.
+            std::vector<unsigned char> table;
+            std::uint_fast32_t table_bound;
+            std::uint_fast32_t table_period;
         };
 
 
@@ -227,6 +271,12 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
     inline void PluralParser::DebugPrintCode() const
     {
     }
+    inline void PluralParser::FunctionType::DebugPrintInstruction(const InstructionT &)
+    {
+    }
+    inline void PluralParser::FunctionType::DebugPrintProgram() const
+    {
+    }
 #else
     inline void PluralParser::DebugPrintOpcode(Opcode op)
     {
@@ -334,6 +384,36 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
     {
         DebugPrintCode(code);
     }
+    inline void PluralParser::FunctionType::DebugPrintInstruction(const InstructionT &inst)
+    {
+        static const char *const names[] = {
+            "PUSH_NUM", "PUSH_VAR", "PUSH_REG", "NOT", "BOOL",
+            "MULT", "DIV", "MOD", "ADD", "SUB", "LE", "LT", "GT", "GE", "EQ", "NE", "AND", "OR",
+            "MULT_NUM", "DIV_NUM", "MOD_NUM", "ADD_NUM", "SUB_NUM", "LE_NUM", "LT_NUM", "GT_NUM", "GE_NUM", "EQ_NUM", "NE_NUM", "AND_NUM", "OR_NUM",
+            "VAR_MULT_NUM", "VAR_DIV_NUM", "VAR_MOD_NUM", "VAR_ADD_NUM", "VAR_SUB_NUM", "VAR_LE_NUM", "VAR_LT_NUM", "VAR_GT_NUM", "VAR_GE_NUM", "VAR_EQ_NUM", "VAR_NE_NUM", "VAR_AND_NUM", "VAR_OR_NUM",
+            "REG_MULT_NUM", "REG_DIV_NUM", "REG_MOD_NUM", "REG_ADD_NUM", "REG_SUB_NUM", "REG_LE_NUM", "REG_LT_NUM", "REG_GT_NUM", "REG_GE_NUM", "REG_EQ_NUM", "REG_NE_NUM", "REG_AND_NUM", "REG_OR_NUM",
+            "SET_REG_VAR_MOD_NUM", "JUMP_IF_FALSE", "JUMP_IF_TRUE", "JUMP", "RETURN",
+        };
+        if (inst.op <= OP_RETURN) {
+            std::cout << names[inst.op];
+        } else {
+            std::cout << static_cast<unsigned int>(inst.op);
+        }
+        if (inst.op == OP_PUSH_REG || (inst.op >= OP_REG_MULT_NUM && inst.op <= OP_SET_REG_VAR_MOD_NUM)) {
+            std::cout << " r" << static_cast<unsigned int>(inst.reg);
+        }
+        if (inst.op == OP_PUSH_NUM || (inst.op >= OP_MULT_NUM && inst.op <= OP_JUMP)) {
+            std::cout << ' ' << inst.operand;
+        }
+    }
+    inline void PluralParser::FunctionType::DebugPrintProgram() const
+    {
+        for (size_t i = 0; i < program.size(); ++i) {
+            std::cout << i << ": ";
+            DebugPrintInstruction(program[i]);
+            std::cout << std::endl;
+        }
+    }
 #endif // SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT
 
 
@@ -343,21 +423,8 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
     {
     }
 
-    inline PluralParser::FunctionType::FunctionType(const std::vector<PluralParser::Opcode> &program,
-                                                    size_t max_data_size)
-        : compiled_func(nullptr),
-          code(program),
-          data(max_data_size)
-    {
-        // We can read an item at the current position + 4 without checking.
-        code.push_back(END);
-        code.push_back(END);
-        code.push_back(END);
-        code.push_back(END);
-    }
-
     inline PluralParser::FunctionType::FunctionType(CompiledPluralFunctionT func)
-        : compiled_func(func), code(0), data(0)
+        : compiled_func(func), program(), stack_size(0), table(), table_bound(0), table_period(1)
     {
     }
 
@@ -372,16 +439,713 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
         return n;
     }
 
-    inline std::uint_fast32_t PluralParser::FunctionType::Read32(size_t &i) const
+    // This class compiles the bytecode into the instructions of FunctionType.
+    // The bytecode is converted into a tree, optimized, and emitted with the superinstructions:
+    // - The constant expressions are folded, except for the division by zero.
+    // - The boolean expressions are simplified, such as "!(a < b)" to "a >= b" and "c ? 1 : 0" to "c".
+    // - n % k used more than once is calculated only once into a register.
+    // - The conditions of "?:" are short-circuited, unless the skipped operand may divide by zero.
+    // - The jumps to a jump are threaded, and the jumps to the end are replaced by the return.
+    class PluralParser::FunctionType::Compiler {
+    public:
+        Compiler(const std::vector<PluralParser::Opcode> &code, bool optimize);
+        void Emit(std::vector<InstructionT> &program);
+        bool IsPeriodic(std::uint_fast32_t &bound, std::uint_fast32_t &period) const;
+
+    private:
+        enum : unsigned char { N_NUM, N_VAR, N_REG, N_NOT, N_BOOL, N_BINARY, N_COND };
+        // A node of the tree.
+        struct NodeT {
+            unsigned char kind;
+            PluralParser::Opcode op; // The opcode (MULT..OR) of N_BINARY.
+            std::uint_fast32_t value; // The number of N_NUM, or the register of N_REG.
+            size_t a, b, c; // The operands. N_COND is "a ? b : c".
+        };
+
+        static PluralParser::Opcode Read(const std::vector<PluralParser::Opcode> &code, size_t &i, std::uint_fast32_t &operand);
+        size_t Build(const std::vector<PluralParser::Opcode> &code, size_t &i, size_t end);
+        size_t NewNode(unsigned char kind, PluralParser::Opcode op, std::uint_fast32_t value, size_t a = 0, size_t b = 0, size_t c = 0);
+        size_t NewNumber(std::uint_fast32_t value);
+        bool IsNumber(size_t n) const;
+        bool IsBoolean(size_t n) const;
+        bool MayTrap(size_t n) const;
+        bool IsEqual(size_t x, size_t y) const;
+        static bool Apply(PluralParser::Opcode op, std::uint_fast32_t x, std::uint_fast32_t y, std::uint_fast32_t &result);
+        size_t Simplify(size_t n);
+        size_t MakeNot(size_t x);
+        size_t MakeBool(size_t x);
+        size_t MakeBinary(PluralParser::Opcode op, size_t l, size_t r);
+        size_t MakeCond(size_t c, size_t t, size_t e);
+        bool IsPeriodic(size_t n, std::uint_fast32_t &bound, std::uint_fast32_t &period) const;
+        bool IsPeriodicCondition(size_t n, std::uint_fast32_t &bound, std::uint_fast32_t &period) const;
+        static bool UpdateBound(std::uint_fast32_t k, std::uint_fast32_t &bound);
+        static bool UpdatePeriod(std::uint_fast32_t k, std::uint_fast32_t &period);
+        void AllocateRegisters();
+        void CountModulus(size_t n, std::vector<std::pair<std::uint_fast32_t, size_t>> &counts) const;
+        size_t ReplaceModulus(size_t n);
+        size_t Emit(OperationT op, std::uint_fast32_t operand = 0, unsigned char reg = 0);
+        void Patch(const std::vector<size_t> &jumps, size_t target);
+        void EmitValue(size_t n);
+        void EmitCondition(size_t n, bool sense, std::vector<size_t> &jumps);
+
+        const bool optimize;
+        std::vector<NodeT> nodes;
+        size_t root;
+        std::vector<std::uint_fast32_t> moduli; // The modulus of each register.
+        std::vector<InstructionT> *out;
+    };
+
+    inline PluralParser::FunctionType::Compiler::Compiler(const std::vector<PluralParser::Opcode> &code, const bool optimize)
+        : optimize(optimize), nodes(), root(0), moduli(), out(nullptr)
     {
-        NumT n = code[i];
-        n <<= 8;
-        n |= code[++i];
-        n <<= 8;
-        n |= code[++i];
-        n <<= 8;
-        n |= code[++i];
-        return n;
+        size_t i = 0;
+        root = Build(code, i, code.size());
+        assert(i == code.size());
+        if (optimize) {
+            root = Simplify(root);
+            AllocateRegisters();
+        }
+    }
+
+    // Read an instruction of the bytecode, and advance i.
+    // The operand of a jump is the absolute index of the target.
+    inline PluralParser::Opcode PluralParser::FunctionType::Compiler::Read(const std::vector<PluralParser::Opcode> &code, size_t &i, std::uint_fast32_t &operand)
+    {
+        const PluralParser::Opcode op = code[i];
+        operand = 0;
+        if (op == NUM || op == IF || op == ELSE) {
+            assert(i + 1 < code.size());
+            operand = code[i + 1];
+            i += 2;
+        } else if (op == NUM32 || op == IF32 || op == ELSE32) {
+            assert(i + 4 < code.size());
+            operand = (static_cast<std::uint_fast32_t>(code[i + 1]) << 24) | (static_cast<std::uint_fast32_t>(code[i + 2]) << 16)
+                | (static_cast<std::uint_fast32_t>(code[i + 3]) << 8) | code[i + 4];
+            i += 5;
+        } else {
+            i += 1;
+        }
+        if (op == IF || op == IF32 || op == ELSE || op == ELSE32) {
+            // The address is relative to the next instruction.
+            operand += static_cast<std::uint_fast32_t>(i);
+            assert(operand <= code.size());
+        }
+        return op;
+    }
+
+    // Convert the bytecode from i to end, or to ELSE, into a tree, and return the root.
+    inline size_t PluralParser::FunctionType::Compiler::Build(const std::vector<PluralParser::Opcode> &code, size_t &i, const size_t end)
+    {
+        std::vector<size_t> stack;
+        while (i < end) {
+            size_t next = i;
+            std::uint_fast32_t operand;
+            const PluralParser::Opcode op = Read(code, next, operand);
+            if (op == ELSE || op == ELSE32) {
+                // The end of the then-part.
+                break;
+            }
+            i = next;
+            if (op == NUM || op == NUM32) {
+                stack.push_back(NewNumber(operand));
+            } else if (op == VAR) {
+                stack.push_back(NewNode(N_VAR, 0, 0));
+            } else if (op == NOT || op == BOOL) {
+                assert(!stack.empty());
+                stack.back() = NewNode(op == NOT ? N_NOT : N_BOOL, 0, 0, stack.back());
+            } else if (op >= MULT && op <= OR) {
+                assert(stack.size() >= 2);
+                const size_t r = stack.back();
+                stack.pop_back();
+                stack.back() = NewNode(N_BINARY, op, 0, stack.back(), r);
+            } else if (op == IF || op == IF32) {
+                assert(!stack.empty());
+                const size_t t = Build(code, i, operand);
+                std::uint_fast32_t endif;
+                const PluralParser::Opcode else_op = Read(code, i, endif);
+                assert(else_op == ELSE || else_op == ELSE32);
+                (void)else_op;
+                assert(i == operand);
+                const size_t e = Build(code, i, endif);
+                assert(i == endif);
+                stack.back() = NewNode(N_COND, 0, 0, stack.back(), t, e);
+            } else {
+                assert(false);
+            }
+        }
+        assert(stack.size() == 1);
+        return stack.back();
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::NewNode(const unsigned char kind, const PluralParser::Opcode op, const std::uint_fast32_t value, const size_t a, const size_t b, const size_t c)
+    {
+        NodeT node;
+        node.kind = kind;
+        node.op = op;
+        node.value = value;
+        node.a = a;
+        node.b = b;
+        node.c = c;
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::NewNumber(const std::uint_fast32_t value)
+    {
+        return NewNode(N_NUM, 0, value);
+    }
+
+    inline bool PluralParser::FunctionType::Compiler::IsNumber(const size_t n) const
+    {
+        return nodes[n].kind == N_NUM;
+    }
+
+    // Return true if the value is always 0 or 1.
+    inline bool PluralParser::FunctionType::Compiler::IsBoolean(const size_t n) const
+    {
+        const NodeT &node = nodes[n];
+        switch (node.kind) {
+        case N_NUM:
+            return node.value <= 1;
+        case N_NOT:
+        case N_BOOL:
+            return true;
+        case N_BINARY:
+            return node.op >= LE && node.op <= OR;
+        case N_COND:
+            return IsBoolean(node.b) && IsBoolean(node.c);
+        default:
+            return false;
+        }
+    }
+
+    // Return true if the expression may divide by zero. Such an expression is never removed.
+    inline bool PluralParser::FunctionType::Compiler::MayTrap(const size_t n) const
+    {
+        const NodeT &node = nodes[n];
+        switch (node.kind) {
+        case N_NOT:
+        case N_BOOL:
+            return MayTrap(node.a);
+        case N_BINARY:
+            if ((node.op == DIV || node.op == MOD) && !(IsNumber(node.b) && nodes[node.b].value != 0)) {
+                return true;
+            }
+            return MayTrap(node.a) || MayTrap(node.b);
+        case N_COND:
+            return MayTrap(node.a) || MayTrap(node.b) || MayTrap(node.c);
+        default:
+            return false;
+        }
+    }
+
+    inline bool PluralParser::FunctionType::Compiler::IsEqual(const size_t x, const size_t y) const
+    {
+        const NodeT &a = nodes[x];
+        const NodeT &b = nodes[y];
+        if (a.kind != b.kind) {
+            return false;
+        }
+        switch (a.kind) {
+        case N_NUM:
+        case N_REG:
+            return a.value == b.value;
+        case N_VAR:
+            return true;
+        case N_NOT:
+        case N_BOOL:
+            return IsEqual(a.a, b.a);
+        case N_BINARY:
+            return a.op == b.op && IsEqual(a.a, b.a) && IsEqual(a.b, b.b);
+        default:
+            return IsEqual(a.a, b.a) && IsEqual(a.b, b.b) && IsEqual(a.c, b.c);
+        }
+    }
+
+    // Calculate "x op y" in the same way as the interpreter. Return false for the division by zero.
+    inline bool PluralParser::FunctionType::Compiler::Apply(const PluralParser::Opcode op, const std::uint_fast32_t x, const std::uint_fast32_t y, std::uint_fast32_t &result)
+    {
+        switch (op) {
+        case MULT: result = x * y; break;
+        case DIV: if (y == 0) { return false; } result = x / y; break;
+        case MOD: if (y == 0) { return false; } result = x % y; break;
+        case ADD: result = x + y; break;
+        case SUB: result = x - y; break;
+        case LE: result = x <= y; break;
+        case LT: result = x < y; break;
+        case GT: result = x > y; break;
+        case GE: result = x >= y; break;
+        case EQ: result = x == y; break;
+        case NE: result = x != y; break;
+        case AND: result = x && y; break;
+        case OR: result = x || y; break;
+        default: return false;
+        }
+        return true;
+    }
+
+    // Return the simplified node. The nodes are never modified, so they can be shared.
+    inline size_t PluralParser::FunctionType::Compiler::Simplify(const size_t n)
+    {
+        const NodeT node = nodes[n];
+        switch (node.kind) {
+        case N_NOT:
+            return MakeNot(Simplify(node.a));
+        case N_BOOL:
+            return MakeBool(Simplify(node.a));
+        case N_BINARY:
+            return MakeBinary(node.op, Simplify(node.a), Simplify(node.b));
+        case N_COND:
+            return MakeCond(Simplify(node.a), Simplify(node.b), Simplify(node.c));
+        default:
+            return n;
+        }
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::MakeNot(const size_t x)
+    {
+        const NodeT node = nodes[x];
+        if (node.kind == N_NUM) {
+            return NewNumber(node.value == 0);
+        } else if (node.kind == N_NOT) {
+            return MakeBool(node.a);
+        } else if (node.kind == N_BOOL) {
+            return MakeNot(node.a);
+        } else if (node.kind == N_BINARY && node.op >= LE && node.op <= NE) {
+            // !(a < b) is a >= b, and so on.
+            static const PluralParser::Opcode inverse[] = { GT, GE, LE, LT, NE, EQ };
+            return NewNode(N_BINARY, inverse[node.op - LE], 0, node.a, node.b);
+        }
+        return NewNode(N_NOT, 0, 0, x);
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::MakeBool(const size_t x)
+    {
+        if (IsNumber(x)) {
+            return NewNumber(nodes[x].value != 0);
+        } else if (IsBoolean(x)) {
+            return x;
+        }
+        return NewNode(N_BOOL, 0, 0, x);
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::MakeBinary(const PluralParser::Opcode op, const size_t l, const size_t r)
+    {
+        std::uint_fast32_t result;
+        if (IsNumber(l) && IsNumber(r) && Apply(op, nodes[l].value, nodes[r].value, result)) {
+            return NewNumber(result);
+        }
+        if (IsNumber(l) && op >= LE && op <= NE) {
+            // "k < x" is "x > k", so it can be a superinstruction.
+            static const PluralParser::Opcode swapped[] = { GE, GT, LT, LE, EQ, NE };
+            return MakeBinary(swapped[op - LE], r, l);
+        }
+        if ((op == AND || op == OR) && (IsNumber(l) || IsNumber(r))) {
+            const size_t k = IsNumber(l) ? l : r;
+            const size_t x = IsNumber(l) ? r : l;
+            const bool value = nodes[k].value != 0;
+            if (value == (op == AND)) {
+                // "x && 1" and "x || 0" are "!!x".
+                return MakeBool(x);
+            } else if (!MayTrap(x)) {
+                // "x && 0" is 0, and "x || 1" is 1.
+                return NewNumber(value);
+            }
+        }
+        if (IsNumber(r)) {
+            const std::uint_fast32_t k = nodes[r].value;
+            if ((k == 0 && (op == ADD || op == SUB)) || (k == 1 && (op == MULT || op == DIV))) {
+                return l;
+            }
+            if (k == 1 && op == MOD && !MayTrap(l)) {
+                return NewNumber(0);
+            }
+        }
+        if (IsNumber(l) && ((nodes[l].value == 0 && op == ADD) || (nodes[l].value == 1 && op == MULT))) {
+            return r;
+        }
+        return NewNode(N_BINARY, op, 0, l, r);
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::MakeCond(size_t c, size_t t, size_t e)
+    {
+        if (IsNumber(c)) {
+            return nodes[c].value != 0 ? t : e;
+        }
+        if (nodes[c].kind == N_NOT) {
+            c = nodes[c].a;
+            std::swap(t, e);
+        } else if (nodes[c].kind == N_BOOL) {
+            c = nodes[c].a;
+        }
+        if (IsEqual(t, e) && !MayTrap(c)) {
+            return t;
+        }
+        if (IsNumber(t) && IsNumber(e)) {
+            if (nodes[t].value == 1 && nodes[e].value == 0) {
+                return MakeBool(c);
+            } else if (nodes[t].value == 0 && nodes[e].value == 1) {
+                return MakeNot(c);
+            }
+        }
+        return NewNode(N_COND, 0, 0, c, t, e);
+    }
+
+    // Return true if the value for n >= bound depends only on n % period.
+    // It's true if n is used only in "n % k" and in the comparisons with the constants, because the comparisons are constant for n > k.
+    inline bool PluralParser::FunctionType::Compiler::IsPeriodic(std::uint_fast32_t &bound, std::uint_fast32_t &period) const
+    {
+        bound = 0;
+        period = 1;
+        // The table is made by executing the program, so it must not divide by zero.
+        return !MayTrap(root) && IsPeriodic(root, bound, period);
+    }
+
+    inline bool PluralParser::FunctionType::Compiler::IsPeriodic(const size_t n, std::uint_fast32_t &bound, std::uint_fast32_t &period) const
+    {
+        const NodeT &node = nodes[n];
+        switch (node.kind) {
+        case N_NUM:
+            return true;
+        case N_VAR:
+            // n is used as a number.
+            return false;
+        case N_REG:
+            return UpdatePeriod(moduli[node.value], period);
+        case N_NOT:
+        case N_BOOL:
+            return IsPeriodicCondition(node.a, bound, period);
+        case N_BINARY:
+            if (node.op == MOD && nodes[node.a].kind == N_VAR && IsNumber(node.b)) {
+                return UpdatePeriod(nodes[node.b].value, period);
+            } else if (node.op >= LE && node.op <= NE && (nodes[node.a].kind == N_VAR || nodes[node.b].kind == N_VAR)) {
+                const size_t k = nodes[node.a].kind == N_VAR ? node.b : node.a;
+                return IsNumber(k) && UpdateBound(nodes[k].value, bound);
+            } else if (node.op == AND || node.op == OR) {
+                return IsPeriodicCondition(node.a, bound, period) && IsPeriodicCondition(node.b, bound, period);
+            }
+            return IsPeriodic(node.a, bound, period) && IsPeriodic(node.b, bound, period);
+        case N_COND:
+            return IsPeriodicCondition(node.a, bound, period) && IsPeriodic(node.b, bound, period) && IsPeriodic(node.c, bound, period);
+        default:
+            return false;
+        }
+    }
+
+    // n as a condition is "n != 0".
+    inline bool PluralParser::FunctionType::Compiler::IsPeriodicCondition(const size_t n, std::uint_fast32_t &bound, std::uint_fast32_t &period) const
+    {
+        if (nodes[n].kind == N_VAR) {
+            return UpdateBound(0, bound);
+        }
+        return IsPeriodic(n, bound, period);
+    }
+
+    inline bool PluralParser::FunctionType::Compiler::UpdateBound(const std::uint_fast32_t k, std::uint_fast32_t &bound)
+    {
+        if (k >= MAX_TABLE_SIZE) {
+            return false;
+        }
+        bound = std::max<std::uint_fast32_t>(bound, k + 1);
+        return true;
+    }
+
+    // period is the least common multiple of the moduli.
+    inline bool PluralParser::FunctionType::Compiler::UpdatePeriod(const std::uint_fast32_t k, std::uint_fast32_t &period)
+    {
+        if (k == 0 || k >= MAX_TABLE_SIZE) {
+            return false;
+        }
+        std::uint_fast32_t a = period;
+        std::uint_fast32_t b = k;
+        while (b != 0) {
+            const std::uint_fast32_t r = a % b;
+            a = b;
+            b = r;
+        }
+        period = period / a * k;
+        return period < MAX_TABLE_SIZE;
+    }
+
+    // Replace n % k used more than once with a register.
+    inline void PluralParser::FunctionType::Compiler::AllocateRegisters()
+    {
+        std::vector<std::pair<std::uint_fast32_t, size_t>> counts;
+        CountModulus(root, counts);
+        std::stable_sort(counts.begin(), counts.end(), [](const std::pair<std::uint_fast32_t, size_t> &a, const std::pair<std::uint_fast32_t, size_t> &b) {
+            return a.second > b.second;
+        });
+        for (const auto &it : counts) {
+            if (it.second >= 2 && moduli.size() < MAX_REGISTERS) {
+                moduli.push_back(it.first);
+            }
+        }
+        if (!moduli.empty()) {
+            root = ReplaceModulus(root);
+        }
+    }
+
+    inline void PluralParser::FunctionType::Compiler::CountModulus(const size_t n, std::vector<std::pair<std::uint_fast32_t, size_t>> &counts) const
+    {
+        const NodeT &node = nodes[n];
+        if (node.kind == N_BINARY && node.op == MOD && nodes[node.a].kind == N_VAR && IsNumber(node.b) && nodes[node.b].value != 0) {
+            const std::uint_fast32_t k = nodes[node.b].value;
+            auto it = std::find_if(counts.begin(), counts.end(), [k](const std::pair<std::uint_fast32_t, size_t> &a) { return a.first == k; });
+            if (it == counts.end()) {
+                counts.emplace_back(k, 1);
+            } else {
+                ++it->second;
+            }
+            return;
+        }
+        if (node.kind >= N_NOT) {
+            CountModulus(node.a, counts);
+        }
+        if (node.kind >= N_BINARY) {
+            CountModulus(node.b, counts);
+        }
+        if (node.kind == N_COND) {
+            CountModulus(node.c, counts);
+        }
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::ReplaceModulus(const size_t n)
+    {
+        const NodeT node = nodes[n];
+        if (node.kind == N_BINARY && node.op == MOD && nodes[node.a].kind == N_VAR && IsNumber(node.b)) {
+            const auto it = std::find(moduli.begin(), moduli.end(), nodes[node.b].value);
+            if (it != moduli.end()) {
+                return NewNode(N_REG, 0, static_cast<std::uint_fast32_t>(it - moduli.begin()));
+            }
+            return n;
+        }
+        switch (node.kind) {
+        case N_NOT:
+        case N_BOOL:
+            return NewNode(node.kind, 0, 0, ReplaceModulus(node.a));
+        case N_BINARY:
+            return NewNode(N_BINARY, node.op, 0, ReplaceModulus(node.a), ReplaceModulus(node.b));
+        case N_COND:
+            return NewNode(N_COND, 0, 0, ReplaceModulus(node.a), ReplaceModulus(node.b), ReplaceModulus(node.c));
+        default:
+            return n;
+        }
+    }
+
+    // Emit the program.
+    inline void PluralParser::FunctionType::Compiler::Emit(std::vector<InstructionT> &program)
+    {
+        out = &program;
+        // The registers are calculated at first, because they are used more than once in most cases.
+        for (size_t r = 0; r < moduli.size(); ++r) {
+            Emit(OP_SET_REG_VAR_MOD_NUM, moduli[r], static_cast<unsigned char>(r));
+        }
+        EmitValue(root);
+        Emit(OP_RETURN);
+
+        // Thread the jumps.
+        for (auto &inst : program) {
+            if (inst.op == OP_JUMP_IF_FALSE || inst.op == OP_JUMP_IF_TRUE || inst.op == OP_JUMP) {
+                while (program[inst.operand].op == OP_JUMP) {
+                    inst.operand = program[inst.operand].operand;
+                }
+                if (inst.op == OP_JUMP && program[inst.operand].op == OP_RETURN) {
+                    inst.op = OP_RETURN;
+                    inst.operand = 0;
+                }
+            }
+        }
+        out = nullptr;
+    }
+
+    inline size_t PluralParser::FunctionType::Compiler::Emit(const OperationT op, const std::uint_fast32_t operand, const unsigned char reg)
+    {
+        InstructionT inst;
+        inst.op = op;
+        inst.reg = reg;
+        inst.operand = operand;
+        out->push_back(inst);
+        return out->size() - 1;
+    }
+
+    inline void PluralParser::FunctionType::Compiler::Patch(const std::vector<size_t> &jumps, const size_t target)
+    {
+        for (const size_t i : jumps) {
+            (*out)[i].operand = static_cast<std::uint_fast32_t>(target);
+        }
+    }
+
+    // Emit the instructions to push the value.
+    inline void PluralParser::FunctionType::Compiler::EmitValue(const size_t n)
+    {
+        const NodeT node = nodes[n];
+        switch (node.kind) {
+        case N_NUM:
+            Emit(OP_PUSH_NUM, node.value);
+            break;
+        case N_VAR:
+            Emit(OP_PUSH_VAR);
+            break;
+        case N_REG:
+            Emit(OP_PUSH_REG, 0, static_cast<unsigned char>(node.value));
+            break;
+        case N_NOT:
+        case N_BOOL:
+            EmitValue(node.a);
+            Emit(node.kind == N_NOT ? OP_NOT : OP_BOOL);
+            break;
+        case N_BINARY: {
+            const unsigned int index = node.op - MULT;
+            if (!IsNumber(node.b)) {
+                EmitValue(node.a);
+                EmitValue(node.b);
+                Emit(static_cast<OperationT>(OP_MULT + index));
+            } else if (nodes[node.a].kind == N_VAR) {
+                Emit(static_cast<OperationT>(OP_VAR_MULT_NUM + index), nodes[node.b].value);
+            } else if (nodes[node.a].kind == N_REG) {
+                Emit(static_cast<OperationT>(OP_REG_MULT_NUM + index), nodes[node.b].value, static_cast<unsigned char>(nodes[node.a].value));
+            } else {
+                EmitValue(node.a);
+                Emit(static_cast<OperationT>(OP_MULT_NUM + index), nodes[node.b].value);
+            }
+            break;
+        }
+        case N_COND: {
+            std::vector<size_t> to_else;
+            EmitCondition(node.a, false, to_else);
+            EmitValue(node.b);
+            const size_t to_endif = Emit(OP_JUMP);
+            Patch(to_else, out->size());
+            EmitValue(node.c);
+            Patch(std::vector<size_t>(1, to_endif), out->size());
+            break;
+        }
+        default:
+            assert(false);
+        }
+    }
+
+    // Emit the instructions to jump if the condition is sense. The jumps to patch are added to jumps.
+    inline void PluralParser::FunctionType::Compiler::EmitCondition(const size_t n, const bool sense, std::vector<size_t> &jumps)
+    {
+        const NodeT node = nodes[n];
+        if (optimize) {
+            if (node.kind == N_NUM) {
+                if ((node.value != 0) == sense) {
+                    jumps.push_back(Emit(OP_JUMP));
+                }
+                return;
+            } else if (node.kind == N_NOT || node.kind == N_BOOL) {
+                EmitCondition(node.a, node.kind == N_NOT ? !sense : sense, jumps);
+                return;
+            } else if (node.kind == N_BINARY && (node.op == AND || node.op == OR) && !MayTrap(node.b)) {
+                // "a && b" jumps if a is false, and "a || b" jumps if a is true.
+                const bool short_circuit = node.op == OR;
+                if (sense == short_circuit) {
+                    EmitCondition(node.a, sense, jumps);
+                    EmitCondition(node.b, sense, jumps);
+                } else {
+                    std::vector<size_t> skip;
+                    EmitCondition(node.a, short_circuit, skip);
+                    EmitCondition(node.b, sense, jumps);
+                    Patch(skip, out->size());
+                }
+                return;
+            }
+        }
+        EmitValue(n);
+        jumps.push_back(Emit(sense ? OP_JUMP_IF_TRUE : OP_JUMP_IF_FALSE));
+    }
+
+    inline PluralParser::FunctionType::FunctionType(const std::vector<PluralParser::Opcode> &program,
+                                                    size_t max_data_size)
+        : compiled_func(nullptr),
+          program(),
+          stack_size(0),
+          table(),
+          table_bound(0),
+          table_period(1)
+    {
+#ifdef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_OPTIMIZATION
+        Compiler compiler(program, false);
+#else
+        Compiler compiler(program, true);
+#endif
+        compiler.Emit(this->program);
+        Verify();
+        // The optimization never makes the stack deeper.
+        assert(stack_size <= max_data_size);
+        (void)max_data_size;
+#ifndef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+        std::uint_fast32_t bound;
+        std::uint_fast32_t period;
+        if (compiler.IsPeriodic(bound, period)) {
+            CreateTable(bound, period);
+        }
+#endif
+    }
+
+    // Create the lookup table from the results of the program.
+    // The direct part also covers the first period and MIN_TABLE_DIRECT_SIZE, so the small numbers need no division.
+    inline void PluralParser::FunctionType::CreateTable(const std::uint_fast32_t bound, const std::uint_fast32_t period)
+    {
+        const std::uint_fast32_t direct = std::max(std::max(bound, period), static_cast<std::uint_fast32_t>(MIN_TABLE_DIRECT_SIZE));
+        if (direct + period > MAX_TABLE_SIZE) {
+            return;
+        }
+        std::vector<std::uint_fast32_t> stack(stack_size);
+        std::vector<unsigned char> results(direct + period);
+        for (std::uint_fast32_t n = 0; n < direct + period; ++n) {
+            const std::uint_fast32_t result = Execute(n, stack.data());
+            if (result > std::numeric_limits<unsigned char>::max()) {
+                return;
+            }
+            results[n < direct ? n : direct + n % period] = static_cast<unsigned char>(result);
+        }
+        table.swap(results);
+        table_bound = direct;
+        table_period = period;
+    }
+
+    // Verify the stack depth and the registers, so the execution has no bounds check. The jumps are always forward.
+    inline void PluralParser::FunctionType::Verify()
+    {
+        const size_t unknown = static_cast<size_t>(-1);
+        std::vector<size_t> depth(program.size(), unknown);
+        depth[0] = 0;
+        stack_size = 0;
+        for (size_t i = 0; i < program.size(); ++i) {
+            const InstructionT &inst = program[i];
+            const size_t d = depth[i];
+            if (d == unknown) {
+                // Unreachable.
+                continue;
+            }
+            size_t next = d;
+            if (inst.op == OP_PUSH_NUM || inst.op == OP_PUSH_VAR || inst.op == OP_PUSH_REG || (inst.op >= OP_VAR_MULT_NUM && inst.op <= OP_REG_OR_NUM)) {
+                next = d + 1;
+            } else if ((inst.op >= OP_MULT && inst.op <= OP_OR) || inst.op == OP_JUMP_IF_FALSE || inst.op == OP_JUMP_IF_TRUE) {
+                assert(d >= (inst.op >= OP_MULT && inst.op <= OP_OR ? 2U : 1U));
+                next = d - 1;
+            } else if (inst.op == OP_RETURN) {
+                assert(d == 1);
+                continue;
+            } else if (inst.op != OP_SET_REG_VAR_MOD_NUM) {
+                assert(d >= 1);
+            }
+            assert(inst.reg < MAX_REGISTERS);
+            stack_size = std::max(stack_size, next);
+            if (inst.op == OP_JUMP_IF_FALSE || inst.op == OP_JUMP_IF_TRUE || inst.op == OP_JUMP) {
+                assert(inst.operand > i && inst.operand < program.size());
+                assert(depth[inst.operand] == unknown || depth[inst.operand] == next);
+                depth[inst.operand] = next;
+            }
+            if (inst.op != OP_JUMP) {
+                assert(i + 1 < program.size());
+                assert(depth[i + 1] == unknown || depth[i + 1] == next);
+                depth[i + 1] = next;
+            }
+        }
     }
 
     inline PluralParser::NumT PluralParser::FunctionType::operator()(const NumT n) const
@@ -390,124 +1154,141 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
             return compiled_func(n);
         }
 
+        const std::uint_fast32_t n32 = Equivalent32bitUint(n);
+        if (!table.empty()) {
+            // n32 and table_period fit in 32 bits, and the 32-bit division is faster.
+            return n32 < table_bound ? table[n32] : table[table_bound + static_cast<std::uint32_t>(n32) % static_cast<std::uint32_t>(table_period)];
+        }
+
 #ifdef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT_EXECUTE
-        PluralParser::DebugPrintCode(code);
+        DebugPrintProgram();
 #endif
-        const std::uint_fast32_t n32 = Equivalent32bitUint(n);
-        size_t top = static_cast<size_t>(-1);
-        for (size_t i = 0; i < code.size() && code[i] != END; ++i) {
+        if (stack_size <= LOCAL_STACK_SIZE) {
+            std::uint_fast32_t stack[LOCAL_STACK_SIZE];
+            return Execute(n32, stack);
+        }
+        // A deeply nested expression needs a larger stack.
+        std::vector<std::uint_fast32_t> stack(stack_size);
+        return Execute(n32, stack.data());
+    }
+
+    // Execute the program. stack has stack_size items at least.
+    // The dispatch is direct-threaded by computed goto if the compiler supports it.
+#if defined(__GNUC__) && !defined(SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_SWITCH) && !defined(SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT_EXECUTE)
+#define SPIRITLESS_PO_PLURAL_PARSER_USE_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+    inline std::uint_fast32_t PluralParser::FunctionType::Execute(const std::uint_fast32_t n32, std::uint_fast32_t *const stack) const
+    {
+        const InstructionT *const base = program.data();
+        const InstructionT *ip = base;
+        // sp points to the next of the top of the stack.
+        std::uint_fast32_t *sp = stack;
+        // The registers are set by OP_SET_REG_VAR_MOD_NUM before they are used.
+        std::uint_fast32_t regs[MAX_REGISTERS];
+#ifdef SPIRITLESS_PO_PLURAL_PARSER_USE_COMPUTED_GOTO
+        // The order is the same as the operations.
+        static const void *const labels[] = {
+            &&L_OP_PUSH_NUM, &&L_OP_PUSH_VAR, &&L_OP_PUSH_REG, &&L_OP_NOT, &&L_OP_BOOL,
+            &&L_OP_MULT, &&L_OP_DIV, &&L_OP_MOD, &&L_OP_ADD, &&L_OP_SUB, &&L_OP_LE, &&L_OP_LT, &&L_OP_GT, &&L_OP_GE, &&L_OP_EQ, &&L_OP_NE, &&L_OP_AND, &&L_OP_OR,
+            &&L_OP_MULT_NUM, &&L_OP_DIV_NUM, &&L_OP_MOD_NUM, &&L_OP_ADD_NUM, &&L_OP_SUB_NUM, &&L_OP_LE_NUM, &&L_OP_LT_NUM, &&L_OP_GT_NUM, &&L_OP_GE_NUM, &&L_OP_EQ_NUM, &&L_OP_NE_NUM, &&L_OP_AND_NUM, &&L_OP_OR_NUM,
+            &&L_OP_VAR_MULT_NUM, &&L_OP_VAR_DIV_NUM, &&L_OP_VAR_MOD_NUM, &&L_OP_VAR_ADD_NUM, &&L_OP_VAR_SUB_NUM, &&L_OP_VAR_LE_NUM, &&L_OP_VAR_LT_NUM, &&L_OP_VAR_GT_NUM, &&L_OP_VAR_GE_NUM, &&L_OP_VAR_EQ_NUM, &&L_OP_VAR_NE_NUM, &&L_OP_VAR_AND_NUM, &&L_OP_VAR_OR_NUM,
+            &&L_OP_REG_MULT_NUM, &&L_OP_REG_DIV_NUM, &&L_OP_REG_MOD_NUM, &&L_OP_REG_ADD_NUM, &&L_OP_REG_SUB_NUM, &&L_OP_REG_LE_NUM, &&L_OP_REG_LT_NUM, &&L_OP_REG_GT_NUM, &&L_OP_REG_GE_NUM, &&L_OP_REG_EQ_NUM, &&L_OP_REG_NE_NUM, &&L_OP_REG_AND_NUM, &&L_OP_REG_OR_NUM,
+            &&L_OP_SET_REG_VAR_MOD_NUM, &&L_OP_JUMP_IF_FALSE, &&L_OP_JUMP_IF_TRUE, &&L_OP_JUMP, &&L_OP_RETURN,
+        };
+        static_assert(sizeof(labels) / sizeof(labels[0]) == OP_RETURN + 1, "labels must have all the operations.");
+#define SPIRITLESS_PO_PLURAL_PARSER_OP(name) L_##name:
+#define SPIRITLESS_PO_PLURAL_PARSER_DISPATCH() goto *labels[ip->op]
+        SPIRITLESS_PO_PLURAL_PARSER_DISPATCH();
+#else
+#define SPIRITLESS_PO_PLURAL_PARSER_OP(name) case name:
+#define SPIRITLESS_PO_PLURAL_PARSER_DISPATCH() continue
+        for (;;) {
 #ifdef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_PRINT_EXECUTE
-            std::cout << i << ": ";
-            DebugPrintOpcode(code[i]);
+            std::cout << (ip - base) << ": ";
+            DebugPrintInstruction(*ip);
             std::cout << std::endl;
 #endif
-            switch (code[i]) {
-            case NUM:
-                ++i;
-                ++top;
-                data.at(top) = code[i];
-                break;
-            case NUM32:
-                ++top;
-                ++i;
-                data.at(top) = Read32(i);
-                break;
-            case NOT:
-                data[top] = !data.at(top);
-                break;
-            case BOOL:
-                data[top] = data.at(top) != 0;
-                break;
-            case MULT:
-                data.at(top - 1) *= data.at(top);
-                --top;
-                break;
-            case DIV:
-                data.at(top-1) /= data.at(top);
-                --top;
-                break;
-            case MOD:
-                data.at(top-1) %= data.at(top);
-                --top;
-                break;
-            case ADD:
-                data.at(top-1) += data.at(top);
-                --top;
-                break;
-            case SUB:
-                data.at(top-1) -= data.at(top);
-                --top;
-                break;
-            case LE:
-                data[top-1] = data.at(top-1) <= data.at(top);
-                --top;
-                break;
-            case LT:
-                data[top-1] = data.at(top-1) < data.at(top);
-                --top;
-                break;
-            case GT:
-                data[top-1] = data.at(top-1) > data.at(top);
-                --top;
-                break;
-            case GE:
-                data[top-1] = data.at(top-1) >= data.at(top);
-                --top;
-                break;
-            case EQ:
-                data[top-1] = data.at(top-1) == data.at(top);
-                --top;
-                break;
-            case NE:
-                data[top-1] = data.at(top-1) != data.at(top);
-                --top;
-                break;
-            case AND:
-                data[top-1] = data.at(top-1) && data.at(top);
-                --top;
-                break;
-            case OR:
-                data[top-1] = data.at(top-1) || data.at(top);
-                --top;
-                break;
-            case IF:
-                ++i;
-                if (!data.at(top)) {
-                    i += code[i];
-                }
-                --top;
-                break;
-            case IF32:
-                {
-                    ++i;
-                    const NumT r = Read32(i);
-                    if (!data.at(top)) {
-                        i += r;
-                    }
-                    --top;
-                }
-                break;
-            case ELSE:
-                ++i;
-                i += code[i];
-                break;
-            case ELSE32:
-                ++i;
-                i += Read32(i);
-                break;
-            case VAR:
-                ++top;
-                data.at(top) = n32;
-                break;
+            switch (ip->op) {
+#endif
+#define SPIRITLESS_PO_PLURAL_PARSER_NEXT() ++ip; SPIRITLESS_PO_PLURAL_PARSER_DISPATCH()
+#define SPIRITLESS_PO_PLURAL_PARSER_BINARY(name, op) \
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_##name) \
+                sp[-2] = sp[-2] op sp[-1]; \
+                --sp; \
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT(); \
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_##name##_NUM) \
+                sp[-1] = sp[-1] op ip->operand; \
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT(); \
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_VAR_##name##_NUM) \
+                *sp++ = n32 op ip->operand; \
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT(); \
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_REG_##name##_NUM) \
+                *sp++ = regs[ip->reg] op ip->operand; \
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_PUSH_NUM)
+                *sp++ = ip->operand;
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_PUSH_VAR)
+                *sp++ = n32;
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_PUSH_REG)
+                *sp++ = regs[ip->reg];
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_NOT)
+                sp[-1] = !sp[-1];
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_BOOL)
+                sp[-1] = sp[-1] != 0;
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(MULT, *)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(DIV, /)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(MOD, %)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(ADD, +)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(SUB, -)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(LE, <=)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(LT, <)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(GT, >)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(GE, >=)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(EQ, ==)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(NE, !=)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(AND, &&)
+            SPIRITLESS_PO_PLURAL_PARSER_BINARY(OR, ||)
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_SET_REG_VAR_MOD_NUM)
+                regs[ip->reg] = n32 % ip->operand;
+                SPIRITLESS_PO_PLURAL_PARSER_NEXT();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_JUMP_IF_FALSE)
+                --sp;
+                ip = *sp ? ip + 1 : base + ip->operand;
+                SPIRITLESS_PO_PLURAL_PARSER_DISPATCH();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_JUMP_IF_TRUE)
+                --sp;
+                ip = *sp ? base + ip->operand : ip + 1;
+                SPIRITLESS_PO_PLURAL_PARSER_DISPATCH();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_JUMP)
+                ip = base + ip->operand;
+                SPIRITLESS_PO_PLURAL_PARSER_DISPATCH();
+            SPIRITLESS_PO_PLURAL_PARSER_OP(OP_RETURN)
+                assert(sp == stack + 1);
+                return sp[-1];
+#ifndef SPIRITLESS_PO_PLURAL_PARSER_USE_COMPUTED_GOTO
             default:
                 assert(false);
+                return 0;
             }
-            assert(i < code.size());
-            assert(top == static_cast<size_t>(-1) || top < data.size());
         }
-        assert(top == 0);
-        return data.at(0);
+#endif
+#undef SPIRITLESS_PO_PLURAL_PARSER_BINARY
+#undef SPIRITLESS_PO_PLURAL_PARSER_NEXT
+#undef SPIRITLESS_PO_PLURAL_PARSER_DISPATCH
+#undef SPIRITLESS_PO_PLURAL_PARSER_OP
     }
+#ifdef SPIRITLESS_PO_PLURAL_PARSER_USE_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#undef SPIRITLESS_PO_PLURAL_PARSER_USE_COMPUTED_GOTO
+#endif
 
 
 
@@ -670,11 +1451,16 @@ namespace SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE {
                 [](NumT n) -> NumT { return n == 0 ? 0 : n == 1 ? 1 : n == 2 ? 2 : n % 100 >= 3 && n % 100 <= 10 ? 3 : n % 100 >= 11 ? 4 : 5; }
             },
         };
+        // The lookup table is faster than the compiled functions.
+        FunctionType f(code, max_data_size);
+        if (!f.table.empty()) {
+            return f;
+        }
         auto it = func_map.find(code);
         if (it != func_map.end()) {
             return FunctionType(it->second);
         } else {
-            return FunctionType(code, max_data_size);
+            return f;
         }
     }
     /* End of the derived work. */
@@ -13,15 +13,34 @@
 #define SPIRITLESS_PO_PO_PARSER_H_
 
 #include "Common.h"
+#include "LoadProfile.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iterator>
 #include <limits>
-#include <locale>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#ifndef SPIRITLESS_PO_DEBUG_PO_PARSER_USE_SCALAR
+#if defined(__AVX2__)
+#define SPIRITLESS_PO_PO_PARSER_USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPIRITLESS_PO_PO_PARSER_USE_SSE2
+#include <emmintrin.h>
+#endif
+#if (defined(SPIRITLESS_PO_PO_PARSER_USE_AVX2) || defined(SPIRITLESS_PO_PO_PARSER_USE_SSE2)) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif // SPIRITLESS_PO_DEBUG_PO_PARSER_USE_SCALAR
+
 namespace spiritless_po {
     /** This class is a parser for the text that contains the PO entries. */
     class PoParser {
@@ -34,6 +53,7 @@ namespace spiritless_po {
         */
         struct PoEntryT {
             std::string msgid; /**< msgid ( + CONTEXT_SEPARATOR + msgctxt if msgctxt exists.) */
+            std::string msgid_plural; /**< msgid_plural, or an empty string if the entry has no msgid_plural. */
             std::vector<std::string> msgstr; /**< msgstr, or msgstr[n] if the entry is for msgid_plural. */
             std::string error; /**< The messages that describe the error in the parsing. */
         };
@@ -48,6 +68,90 @@ namespace spiritless_po {
         template <typename INP, typename Sentinel>
         static std::vector<PoEntryT> GetEntries(INP &&begin, Sentinel &&end);
 
+        /** Type of the PO entries in the columnar form.
+
+            All the decoded strings are stored in text, and each entry refers to them by the offsets, so the entries need a few allocations.
+            - msgid and msgstr are empty when (flags & FLAG_ERROR) != 0.
+            - msgstrCount > 0 when (flags & FLAG_ERROR) == 0.
+            - msgstr[0] is an empty string if (flags & FLAG_FUZZY) != 0.
+        */
+        struct EntryTableT {
+            /** Flags of an entry. */
+            enum FlagT : unsigned int {
+                FLAG_FUZZY = 1, /**< The entry is fuzzy. */
+                FLAG_ERROR = 2, /**< The entry has an error. */
+            };
+
+            /** Type of a string in text. */
+            struct RangeT {
+                std::size_t offset; /**< The offset in text. */
+                std::size_t size; /**< The size of the string. */
+            };
+
+            /** Type of a PO entry. */
+            struct EntryT {
+                RangeT msgid; /**< msgid (msgctxt + CONTEXT_SEPARATOR + msgid if msgctxt exists.) */
+                std::size_t msgstrIndex; /**< The index of msgstr in msgstrs. msgstr[n] is msgstrs[msgstrIndex + n]. */
+                std::size_t msgstrCount; /**< The number of msgstr. */
+                std::size_t errorIndex; /**< The index of the error in errors, if (flags & FLAG_ERROR) != 0. */
+                unsigned int flags; /**< The flags of the entry. (FlagT) */
+            };
+
+            std::string text; /**< All the decoded strings. */
+            std::vector<RangeT> msgstrs; /**< All msgstr. */
+            std::vector<EntryT> entries; /**< The entries in the order of the text. */
+            std::vector<std::string> errors; /**< The messages that describe the errors in the parsing. */
+        };
+
+        /** Parse the text that contains the PO entries into the columnar form.
+            \tparam INP A type of an input iterator.
+            \tparam Sentinel A type of a sentinel.
+            \param [in] begin The beginning of the text to parse.
+            \param [in] end The end of the text to parse.
+            \return The result of the parsing, which has the same entries as GetEntries(begin, end).
+        */
+        template <typename INP, typename Sentinel>
+        static EntryTableT GetEntryTable(INP &&begin, Sentinel &&end);
+
+        /** Parse the text that contains the PO entries on some threads.
+            \param [in] begin The beginning of the text to parse.
+            \param [in] end The end of the text to parse.
+            \param [in] threads The maximum number of the threads, or 0 to use std::thread::hardware_concurrency().
+            \return The result of the parsing, which is the same as GetEntries(begin, end).
+            \note The text is split at the beginnings of the entries after a blank line, and the entries are merged in the order of the text.
+        */
+        static std::vector<PoEntryT> GetEntriesParallel(const char *begin, const char *end, unsigned int threads = 0);
+
+        /** Type of a PO entry whose msgstr isn't decoded.
+
+            - msgid is empty and msgstrBegin == msgstrEnd == nullptr when error is not empty.
+            - msgstrCount > 0 when error is empty.
+        */
+        struct IndexEntryT {
+            std::string msgid; /**< msgid (msgctxt + CONTEXT_SEPARATOR + msgid if msgctxt exists.) */
+            const char *msgstrBegin; /**< The beginning of the msgstr block, that is the first msgstr keyword. */
+            const char *msgstrEnd; /**< The end of the msgstr block, that is the next of the last quoted text. */
+            std::size_t msgstrCount; /**< The number of msgstr. */
+            bool isMsgstr0Empty; /**< msgstr[0] is an empty string, or the entry is fuzzy. */
+            std::string error; /**< The messages that describe the error in the parsing. */
+        };
+
+        /** Parse the text that contains the PO entries, without keeping msgstr.
+            \param [in] begin The beginning of the text to parse.
+            \param [in] end The end of the text to parse.
+            \return The result of the parsing, which has the same msgid and errors as GetEntries(begin, end).
+            \note msgstr is checked without decoding it, and isn't stored. DecodeMsgstr(msgstrBegin, msgstrEnd) decodes it while the text is alive.
+        */
+        static std::vector<IndexEntryT> GetIndexEntries(const char *begin, const char *end);
+
+        /** Decode the msgstr block of an entry.
+            \param [in] begin The beginning of the msgstr block. (IndexEntryT::msgstrBegin)
+            \param [in] end The end of the msgstr block. (IndexEntryT::msgstrEnd)
+            \return msgstr, or msgstr[n] if the entry is for msgid_plural.
+            \note The result doesn't care fuzzy, unlike GetEntries().
+        */
+        static std::vector<std::string> DecodeMsgstr(const char *begin, const char *end);
+
     private:
         // Reading location type.
         class LocationT {
@@ -57,6 +161,7 @@ namespace spiritless_po {
             LocationT &operator=(const LocationT &a) = default;
 
             void Next(char cur_c);
+            void Next(const char *begin, const char *end);
             std::size_t GetLine() const noexcept;
             std::size_t GetColumn() const noexcept;
             std::string ToString() const;
@@ -67,9 +172,12 @@ namespace spiritless_po {
         };
 
         // Char iterator, tracking the location of the source text.
+        // PositionT is a cheap mark of the current position, and GetLocation(pos) converts it to the location.
         template <typename INP, typename Sentinel>
         class CharFeeder {
         public:
+            using PositionT = LocationT;
+
             CharFeeder(INP &it, Sentinel &end, const LocationT &startLoc);
 
             bool IsEnd() const;
@@ -77,6 +185,12 @@ namespace spiritless_po {
             char Get() const;
             void Next();
             const LocationT &GetLocation() const noexcept;
+            const PositionT &GetPosition() const noexcept;
+            const LocationT &GetLocation(const PositionT &pos) const noexcept;
+            void AppendPlainText(std::string &text);
+            void SkipToNewLine();
+            template <std::size_t N>
+            bool StartsWith(const char (&word)[N]);
 
         private:
             INP &curIt;
@@ -136,19 +250,170 @@ namespace spiritless_po {
         // State Transition table
         class StateTransTable {
         public:
-            StateTransTable() noexcept;
-            StateT GetState(StateT state, TokenT token) const noexcept;
+            StateTransTable() = delete;
+            static StateT GetState(StateT state, TokenT token) noexcept;
+        };
+
+        // Character classes for the lexer.
+        enum CharClassT : unsigned char {
+            CHAR_SPACE = 1,
+            CHAR_DIGIT = 2,
+            CHAR_XDIGIT = 4,
+            CHAR_OCTAL = 8,
+        };
+
+        // The text that is checked but isn't decoded. It keeps only the number of the decoded characters.
+        struct TextSizeT {
+            std::size_t size;
+
+            TextSizeT &operator+=(char c) noexcept;
+        };
+
+        // Sink of the PO entries, which makes the entries in PoEntryT.
+        class EntryListSink {
+        public:
+            using OutputT = std::vector<PoEntryT>;
+            // The msgstr texts are decoded.
+            static constexpr bool DECODES_MSGSTR = true;
+
+            EntryListSink();
+
+            bool HasError() const noexcept;
+            // Set the error message, even if the current entry has an error.
+            void SetError(std::string message);
+            // text may be moved into the entry.
+            void AppendMsgid(OutputT &out, std::string &text);
+            void AppendMsgid(OutputT &out, char c);
+            // text may be moved into the entry.
+            void AppendMsgidPlural(OutputT &out, std::string &text);
+            std::size_t GetMsgstrCount() const noexcept;
+            // pos is the position of the msgstr keyword.
+            template <typename PositionT>
+            void AddMsgstr(OutputT &out, const PositionT &pos);
+            // text may be moved into the entry.
+            // end is the position of the next of the quoted text.
+            template <typename PositionT>
+            void AppendMsgstr(OutputT &out, std::string &text, const PositionT &end);
+            // Push the current entry into out, and start a new entry.
+            void FinishEntry(OutputT &out, bool fuzzy);
+
+        private:
+            static void AppendText(std::string &dest, std::string &text);
+
+            PoEntryT curEntry;
+        };
+
+        // Sink of the PO entries, which makes the entries in EntryTableT.
+        class EntryTableSink {
+        public:
+            using OutputT = EntryTableT;
+            // The msgstr texts are decoded.
+            static constexpr bool DECODES_MSGSTR = true;
+
+            EntryTableSink();
+
+            bool HasError() const noexcept;
+            // Set the error message, even if the current entry has an error.
+            void SetError(std::string message);
+            void AppendMsgid(OutputT &out, std::string &text);
+            void AppendMsgid(OutputT &out, char c);
+            // msgid_plural isn't kept.
+            void AppendMsgidPlural(OutputT &out, std::string &text);
+            std::size_t GetMsgstrCount() const noexcept;
+            template <typename PositionT>
+            void AddMsgstr(OutputT &out, const PositionT &pos);
+            template <typename PositionT>
+            void AppendMsgstr(OutputT &out, std::string &text, const PositionT &end);
+            // Push the current entry into out, and start a new entry.
+            void FinishEntry(OutputT &out, bool fuzzy);
+
+        private:
+            std::string error;
+            // The current entry is out.text.size() - msgidSize - msgstrSize to the end.
+            std::size_t msgidSize;
+            std::size_t msgstrSize;
+            // The current msgstr is the last msgstrCount elements of out.msgstrs.
+            std::size_t msgstrCount;
+        };
+
+        // Sink of the PO entries, which makes the entries in IndexEntryT.
+        // It works only with the pointers.
+        class IndexEntrySink {
+        public:
+            using OutputT = std::vector<IndexEntryT>;
+            // The msgstr texts are only checked, and AppendMsgstr() gets an empty text if the decoded text is empty, or a placeholder character otherwise.
+            static constexpr bool DECODES_MSGSTR = false;
+
+            IndexEntrySink();
+
+            bool HasError() const noexcept;
+            // Set the error message, even if the current entry has an error.
+            void SetError(std::string message);
+            void AppendMsgid(OutputT &out, std::string &text);
+            void AppendMsgid(OutputT &out, char c);
+            // msgid_plural isn't kept.
+            void AppendMsgidPlural(OutputT &out, std::string &text);
+            std::size_t GetMsgstrCount() const noexcept;
+            void AddMsgstr(OutputT &out, const char *pos);
+            void AppendMsgstr(OutputT &out, std::string &text, const char *end);
+            // Push the current entry into out, and start a new entry.
+            void FinishEntry(OutputT &out, bool fuzzy);
+
+        private:
+            IndexEntryT curEntry;
+        };
+
+        // Builder of the PO entries, which is driven by the tokens.
+        // Sink makes the entries.
+        template <typename Sink>
+        class EntryBuilder {
+        public:
+            EntryBuilder();
+
+            // The state is EOT.
+            bool IsEnd() const noexcept;
+            // The next entry starts with the same state as the beginning of the text, if the next token is the beginning of an entry.
+            bool IsAtEntryBoundary() const noexcept;
+            // The next text is a part of msgstr.
+            bool IsInMsgstr() const noexcept;
+            // Set the error message if the current entry has no error.
+            void SetError(const std::string &message);
+            // Process a token, and push the entry into out if it's finished.
+            // Return true if the lexical error needs the recovery.
+            // pos is the position of token in it.
+            // text may be moved into the entry.
+            template <typename Feeder>
+            bool Put(TokenT token, const Feeder &it, const typename Feeder::PositionT &pos, std::string &text, std::size_t n_msgstr, typename Sink::OutputT &out);
 
         private:
-            StateT trans[static_cast<unsigned int>(StateT::TOTAL)][static_cast<unsigned int>(TokenT::TOTAL)];
+            StateT state;
+            bool fuzzy;
+            bool hasMsgctxt;
+            Sink sink;
+        };
+
+        // The iterators that point to the contiguous chars, which can be parsed by the pointers.
+        template <typename T>
+        struct IsContiguousCharIterator : std::false_type {
         };
 
+        // The range can be parsed by the pointers.
+        template <typename INP, typename Sentinel>
+        using IsContiguousCharRange = std::integral_constant<bool, IsContiguousCharIterator<typename std::decay<INP>::type>::value && std::is_same<typename std::decay<INP>::type, typename std::decay<Sentinel>::type>::value>;
+
         PoParser() = delete;
         ~PoParser() = delete;
 
         // Internal functions
-        template <typename INP, typename Sentinel>
-        static bool StartsWith(CharFeeder<INP, Sentinel> &it, const char *word);
+        static unsigned char GetCharClass(char c) noexcept;
+        static bool IsSpace(char c) noexcept;
+        static bool IsDigit(char c) noexcept;
+        static bool IsXDigit(char c) noexcept;
+        static bool IsOctal(char c) noexcept;
+        template <typename Sink, typename INP, typename Sentinel>
+        static void Parse(INP &begin, Sentinel &end, typename Sink::OutputT &out, std::true_type isContiguous);
+        template <typename Sink, typename INP, typename Sentinel>
+        static void Parse(INP &begin, Sentinel &end, typename Sink::OutputT &out, std::false_type isContiguous);
         static const char *GetTokenName(PoParser::TokenT t);
         template <typename INP, typename Sentinel>
         static void SkipWhiteSpace(PoParser::CharFeeder<INP, Sentinel> &it);
@@ -160,12 +425,163 @@ namespace spiritless_po {
         static char GetEscapeXChar(CharFeeder<INP, Sentinel> &it);
         template <typename INP, typename Sentinel>
         static char GetEscape0Char(CharFeeder<INP, Sentinel> &it, char firstC);
-        template <typename INP, typename Sentinel>
-        static std::string ParseText(CharFeeder<INP, Sentinel> &it);
+        template <typename INP, typename Sentinel, typename TextT>
+        static void ParseText(CharFeeder<INP, Sentinel> &it, TextT &text);
+        template <typename INP, typename Sentinel, typename TextT>
+        static bool ParseTextBody(CharFeeder<INP, Sentinel> &it, TextT &text);
         template <typename INP, typename Sentinel>
         static TokenT ParseComment(CharFeeder<INP, Sentinel> &it);
         template <typename INP, typename Sentinel>
-        static TokenT Lex(CharFeeder<INP, Sentinel> &it, LocationT &loc, std::string &text, std::size_t &n_msgstr);
+        static TokenT Lex(CharFeeder<INP, Sentinel> &it, typename CharFeeder<INP, Sentinel>::PositionT &pos, std::string &text, std::size_t &n_msgstr);
+        template <typename INP, typename Sentinel>
+        static TokenT LexMsgstr(CharFeeder<INP, Sentinel> &it, typename CharFeeder<INP, Sentinel>::PositionT &pos, std::string &text, std::size_t &n_msgstr);
+        static TokenT LexMsgstr(CharFeeder<const char *, const char *> &it, const char *&pos, std::string &text, std::size_t &n_msgstr);
+        template <typename INP, typename Sentinel>
+        static void SkipToNewLine(CharFeeder<INP, Sentinel> &it);
+        static const char *FindEntryBoundary(const char *begin, const char *end);
+        static const char *FindTextDelimiter(const char *begin, const char *end) noexcept;
+
+    public:
+        /** This class is a parser for the text that is given in chunks.
+
+            The parser keeps the state of the parsing between Feed() calls, so the caller doesn't need to hold the whole text.
+        */
+        class IncrementalParser {
+        public:
+            /** Create a parser that waits for the beginning of the text. */
+            IncrementalParser();
+
+            /** Parse a chunk of the text.
+                \param [in] data The pointer to the chunk.
+                \param [in] size The size of the chunk.
+                \return The entries that are finished by the chunk.
+                \note The unfinished token at the end of the chunk is kept until the next Feed() or Finish().
+            */
+            std::vector<PoEntryT> Feed(const char *data, std::size_t size);
+
+            /** Parse the rest of the text as the end of the text.
+                \return The rest of the entries.
+                \note The parser is reset to wait for the beginning of a new text.
+            */
+            std::vector<PoEntryT> Finish();
+
+        private:
+            friend class PoParser;
+            explicit IncrementalParser(const LocationT &startLoc);
+            const char *Parse(const char *begin, const char *end, bool isLast, std::vector<PoEntryT> &entries);
+            bool ParseLongText(CharFeeder<const char *, const char *> &it, const char *&endIt, bool isLast, std::vector<PoEntryT> &entries);
+            static const char *FindTextCut(const char *begin, const char *end);
+            bool IsAtEntryBoundary() const;
+
+            EntryBuilder<EntryListSink> builder;
+            std::string pending;
+            LocationT loc;
+            bool skipLine;
+            // The quoted text that continues in the next chunk. It's decoded up to the beginning of pending.
+            bool inText;
+            LocationT textLoc;
+            std::string textPrefix;
+            std::string textError;
+        };
+
+        /** This class parses a text in the chunks that are split at the beginnings of the entries.
+
+            Each chunk can be parsed on any thread, and GetEntries() merges the results in the order of the text.
+        */
+        class ChunkedParser {
+        public:
+            /** Split a text into the chunks.
+                \param [in] begin The beginning of the text to parse.
+                \param [in] end The end of the text to parse.
+                \param [in] threads The number of the threads that parse the chunks.
+                \note The text must be kept until GetEntries() is called.
+                \note Too small chunks don't pay for the threads, so a small text isn't split.
+            */
+            ChunkedParser(const char *begin, const char *end, unsigned int threads);
+
+            /** Get the number of the chunks.
+                \return The number of the chunks.
+            */
+            std::size_t GetChunkCount() const noexcept;
+
+            /** Parse a chunk.
+                \param [in] i The index of the chunk.
+                \note The different chunks can be parsed concurrently.
+            */
+            void Parse(std::size_t i);
+
+            /** Merge the results of all chunks.
+                \return The result of the parsing, which is the same as GetEntries(begin, end).
+                \note All chunks must have been parsed.
+            */
+            std::vector<PoEntryT> GetEntries();
+
+        private:
+            struct ChunkResultT {
+                std::vector<PoEntryT> entries;
+                bool isClean;
+            };
+
+            std::vector<const char *> bounds;
+            std::vector<LocationT> startLocs;
+            std::vector<ChunkResultT> results;
+        };
+    };
+
+    // Char iterator for the contiguous chars.
+    // It records only the pointer, and the location is computed when it's needed, such as an error message.
+    template <>
+    class PoParser::CharFeeder<const char *, const char *> {
+    public:
+        using PositionT = const char *;
+
+        CharFeeder(const char *&it, const char *&end, const LocationT &startLoc);
+
+        bool IsEnd() const noexcept;
+        bool IsNotEnd() const noexcept;
+        char Get() const noexcept;
+        void Next() noexcept;
+        LocationT GetLocation() const;
+        PositionT GetPosition() const noexcept;
+        LocationT GetLocation(PositionT pos) const;
+        void AppendPlainText(std::string &text);
+        void AppendPlainText(TextSizeT &text) noexcept;
+        void SkipToNewLine() noexcept;
+        template <std::size_t N>
+        bool StartsWith(const char (&word)[N]) noexcept;
+
+    private:
+        const char *&curIt;
+        const char *&endIt;
+        const char *startIt;
+        LocationT startLoc;
+        // The last computed location, to compute the next one from it.
+        mutable const char *cacheIt;
+        mutable LocationT cacheLoc;
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<char *> : std::true_type {
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<const char *> : std::true_type {
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<std::string::iterator> : std::true_type {
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<std::string::const_iterator> : std::true_type {
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<std::vector<char>::iterator> : std::true_type {
+    };
+
+    template <>
+    struct PoParser::IsContiguousCharIterator<std::vector<char>::const_iterator> : std::true_type {
     };
 
     inline PoParser::LocationT::LocationT(std::size_t line, std::size_t column)
@@ -183,6 +599,21 @@ namespace spiritless_po {
         }
     }
 
+    // Same as calling Next(c) for each character in [begin, end).
+    inline void PoParser::LocationT::Next(const char *begin, const char *const end)
+    {
+        while (begin != end) {
+            const char *const nl = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+            if (nl == nullptr) {
+                break;
+            }
+            ++lineNumber;
+            columnNumber = 1;
+            begin = nl + 1;
+        }
+        columnNumber += end - begin;
+    }
+
     inline std::size_t PoParser::LocationT::GetLine() const noexcept
     {
         return lineNumber;
@@ -237,38 +668,210 @@ namespace spiritless_po {
         return loc;
     }
 
-    inline PoParser::PoParseError::PoParseError(const std::string &whatArg, const LocationT &errorLoc)
-        : std::runtime_error(whatArg), loc(errorLoc)
+    template <typename INP, typename Sentinel>
+    const typename PoParser::CharFeeder<INP, Sentinel>::PositionT &PoParser::CharFeeder<INP, Sentinel>::GetPosition() const noexcept
     {
+        return loc;
     }
 
-    inline PoParser::PoParseError::PoParseError(const char *whatArg, const LocationT &errorLoc)
-        : std::runtime_error(whatArg), loc(errorLoc)
+    template <typename INP, typename Sentinel>
+    const PoParser::LocationT &PoParser::CharFeeder<INP, Sentinel>::GetLocation(const PositionT &pos) const noexcept
     {
+        return pos;
     }
 
-    inline const PoParser::LocationT &PoParser::PoParseError::GetLocation() const noexcept
+    // Append the characters until '"', '\\', '\n', or the end of it.
+    template <typename INP, typename Sentinel>
+    void PoParser::CharFeeder<INP, Sentinel>::AppendPlainText(std::string &text)
     {
-        return loc;
+        while (IsNotEnd()) {
+            const char c = *curIt;
+            if (c == '"' || c == '\\' || c == '\n') {
+                break;
+            }
+            text += c;
+            loc.Next(c);
+            ++curIt;
+        }
+    }
+
+    // Skip until NL.
+    template <typename INP, typename Sentinel>
+    void PoParser::CharFeeder<INP, Sentinel>::SkipToNewLine()
+    {
+        while (IsNotEnd() && *curIt != '\n') {
+            Next();
+        }
     }
 
-    // Compare word with the string comes from the iterator. (Utility function)
-    // Post condition: it.GetLocation() points to the next of word, the first location differed from word, or the end of it.
+    // Compare word with the string comes from the iterator.
+    // Post condition: The iterator points to the next of word, the first location differed from word, or the end of it.
     template <typename INP, typename Sentinel>
-    bool PoParser::StartsWith(CharFeeder<INP, Sentinel> &it, const char *const word)
+    template <std::size_t N>
+    bool PoParser::CharFeeder<INP, Sentinel>::StartsWith(const char (&word)[N])
     {
         const char *p = word;
-        while (it.IsNotEnd() && *p != '\0') {
-            const char c = it.Get();
+        while (IsNotEnd() && *p != '\0') {
+            const char c = *curIt;
             if (c != *p) {
                 break;
             }
-            it.Next();
+            Next();
+            ++p;
+        }
+        return *p == '\0';
+    }
+
+    inline PoParser::CharFeeder<const char *, const char *>::CharFeeder(const char *&it, const char *&end, const LocationT &startLoc)
+        : curIt(it), endIt(end), startIt(it), startLoc(startLoc), cacheIt(it), cacheLoc(startLoc)
+    {
+    }
+
+    inline bool PoParser::CharFeeder<const char *, const char *>::IsEnd() const noexcept
+    {
+        return curIt == endIt;
+    }
+
+    inline bool PoParser::CharFeeder<const char *, const char *>::IsNotEnd() const noexcept
+    {
+        return curIt != endIt;
+    }
+
+    inline char PoParser::CharFeeder<const char *, const char *>::Get() const noexcept
+    {
+        return curIt == endIt ? '\0' : *curIt;
+    }
+
+    inline void PoParser::CharFeeder<const char *, const char *>::Next() noexcept
+    {
+        if (curIt != endIt) {
+            ++curIt;
+        }
+    }
+
+    inline PoParser::LocationT PoParser::CharFeeder<const char *, const char *>::GetLocation() const
+    {
+        return GetLocation(curIt);
+    }
+
+    inline PoParser::CharFeeder<const char *, const char *>::PositionT PoParser::CharFeeder<const char *, const char *>::GetPosition() const noexcept
+    {
+        return curIt;
+    }
+
+    inline PoParser::LocationT PoParser::CharFeeder<const char *, const char *>::GetLocation(const PositionT pos) const
+    {
+        if (pos < cacheIt) {
+            cacheIt = startIt;
+            cacheLoc = startLoc;
+        }
+        cacheLoc.Next(cacheIt, pos);
+        cacheIt = pos;
+        return cacheLoc;
+    }
+
+    // Append the characters until '"', '\\', '\n', or the end of it.
+    inline void PoParser::CharFeeder<const char *, const char *>::AppendPlainText(std::string &text)
+    {
+        const char *const p = FindTextDelimiter(curIt, endIt);
+        text.append(curIt, p);
+        curIt = p;
+    }
+
+    // Skip the characters until '"', '\\', '\n', or the end of it.
+    inline void PoParser::CharFeeder<const char *, const char *>::AppendPlainText(TextSizeT &text) noexcept
+    {
+        const char *const p = FindTextDelimiter(curIt, endIt);
+        text.size += p - curIt;
+        curIt = p;
+    }
+
+    // Skip until NL.
+    inline void PoParser::CharFeeder<const char *, const char *>::SkipToNewLine() noexcept
+    {
+        if (curIt != endIt) {
+            const char *const p = static_cast<const char *>(std::memchr(curIt, '\n', endIt - curIt));
+            curIt = p == nullptr ? endIt : p;
+        }
+    }
+
+    // Compare word with the string comes from the iterator.
+    // Post condition: The iterator points to the next of word, the first location differed from word, or the end of it.
+    template <std::size_t N>
+    bool PoParser::CharFeeder<const char *, const char *>::StartsWith(const char (&word)[N]) noexcept
+    {
+        // Compare the whole word at once in the most cases.
+        const std::size_t len = N - 1;
+        if (static_cast<std::size_t>(endIt - curIt) >= len && std::memcmp(curIt, word, len) == 0) {
+            curIt += len;
+            return true;
+        }
+        const char *p = word;
+        while (curIt != endIt && *p != '\0' && *curIt == *p) {
+            ++curIt;
             ++p;
         }
         return *p == '\0';
     }
 
+    inline PoParser::PoParseError::PoParseError(const std::string &whatArg, const LocationT &errorLoc)
+        : std::runtime_error(whatArg), loc(errorLoc)
+    {
+    }
+
+    inline PoParser::PoParseError::PoParseError(const char *whatArg, const LocationT &errorLoc)
+        : std::runtime_error(whatArg), loc(errorLoc)
+    {
+    }
+
+    inline const PoParser::LocationT &PoParser::PoParseError::GetLocation() const noexcept
+    {
+        return loc;
+    }
+
+    // Character class table. (Utility function)
+    inline unsigned char PoParser::GetCharClass(const char c) noexcept
+    {
+        enum : unsigned char {
+            S = CHAR_SPACE,
+            O = CHAR_OCTAL | CHAR_DIGIT | CHAR_XDIGIT,
+            D = CHAR_DIGIT | CHAR_XDIGIT,
+            X = CHAR_XDIGIT,
+        };
+        // The same as the "C" locale.
+        static constexpr unsigned char table[256] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, S, S, S, S, S, 0, 0, // 0x00
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+            S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x20
+            O, O, O, O, O, O, O, O, D, D, 0, 0, 0, 0, 0, 0, // 0x30
+            0, X, X, X, X, X, X, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x50
+            0, X, X, X, X, X, X, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x70
+        };
+        return table[static_cast<unsigned char>(c)];
+    }
+
+    inline bool PoParser::IsSpace(const char c) noexcept
+    {
+        return (GetCharClass(c) & CHAR_SPACE) != 0;
+    }
+
+    inline bool PoParser::IsDigit(const char c) noexcept
+    {
+        return (GetCharClass(c) & CHAR_DIGIT) != 0;
+    }
+
+    inline bool PoParser::IsXDigit(const char c) noexcept
+    {
+        return (GetCharClass(c) & CHAR_XDIGIT) != 0;
+    }
+
+    inline bool PoParser::IsOctal(const char c) noexcept
+    {
+        return (GetCharClass(c) & CHAR_OCTAL) != 0;
+    }
+
     // Token names for error messages
     inline const char *PoParser::GetTokenName(const PoParser::TokenT t)
     {
@@ -295,7 +898,7 @@ namespace spiritless_po {
     {
         while (it.IsNotEnd()) {
             const char c = it.Get();
-            if (std::isspace(c, std::locale::classic())) {
+            if (IsSpace(c)) {
                 it.Next();
             } else {
                 break;
@@ -311,7 +914,7 @@ namespace spiritless_po {
         std::string s;
         while (it.IsNotEnd()) {
             const char c = it.Get();
-            if (std::isdigit(c, std::locale::classic())) {
+            if (IsDigit(c)) {
                 s += c;
                 it.Next();
             } else {
@@ -332,23 +935,18 @@ namespace spiritless_po {
     template <typename INP, typename Sentinel>
     PoParser::TokenT PoParser::ParseMsgKeyword(CharFeeder<INP, Sentinel> &it, std::size_t &n_msgstr)
     {
-        const LocationT startLoc = it.GetLocation();
+        const auto startPos = it.GetPosition();
         TokenT token = TokenT::ERROR;
-        it.Next();
-        if (StartsWith(it, "sg")) {
+        if (it.StartsWith("msg")) {
             const char c = it.Get();
             if (c == 'c') {
-                it.Next();
-                if (StartsWith(it, "txt")) {
+                if (it.StartsWith("ctxt")) {
                     token = TokenT::MSGCTXT;
                 }
             } else if (c == 'i') {
-                it.Next();
-                if (it.Get() == 'd') {
-                    it.Next();
+                if (it.StartsWith("id")) {
                     if (it.Get() == '_') {
-                        it.Next();
-                        if (StartsWith(it, "plural")) {
+                        if (it.StartsWith("_plural")) {
                             token = TokenT::MSGID_PLURAL;
                         }
                     } else {
@@ -356,8 +954,7 @@ namespace spiritless_po {
                     }
                 }
             } else if (c == 's') {
-                it.Next();
-                if (StartsWith(it, "tr")) {
+                if (it.StartsWith("str")) {
                     SkipWhiteSpace(it);
                     if (it.Get() != '[') {
                         token = TokenT::MSGSTR;
@@ -377,7 +974,7 @@ namespace spiritless_po {
             }
         }
         if (token == TokenT::ERROR) {
-            throw PoParseError("Unknown keyword.", startLoc);
+            throw PoParseError("Unknown keyword.", it.GetLocation(startPos));
         }
         return token;
     }
@@ -394,7 +991,7 @@ namespace spiritless_po {
         // The length "\xh..h" is unlimited.
         while (it.IsNotEnd()) {
             const char c = it.Get();
-            if (std::isxdigit(c, std::locale::classic())) {
+            if (IsXDigit(c)) {
                 if (idx >= 2) {
                     s[0] = s[1];
                     s[1] = c;
@@ -431,7 +1028,7 @@ namespace spiritless_po {
         // The maximum digits number of the escape octal is 3.
         while (it.IsNotEnd()) {
             const char c = it.Get();
-            if (std::isdigit(c, std::locale::classic()) && c != '8' && c != '9') {
+            if (IsOctal(c)) {
                 s[idx] = c;
                 ++idx;
                 it.Next();
@@ -450,21 +1047,36 @@ namespace spiritless_po {
         return static_cast<char>(c);
     }
 
-    // parse a quoted text
+    // parse a quoted text, and append it to text
     // Pre condition: it.Get() == '"'
     // Post condition: it.GetLocation() points to the next of the closing '"', the first location found an error, or the end of it.
-    template <typename INP, typename Sentinel>
-    std::string PoParser::ParseText(CharFeeder<INP, Sentinel> &it)
+    template <typename INP, typename Sentinel, typename TextT>
+    void PoParser::ParseText(CharFeeder<INP, Sentinel> &it, TextT &text)
+    {
+        it.Next();
+        if (!ParseTextBody(it, text)) {
+            throw PoParseError("Closing double quotation mark is expected.", it.GetLocation());
+        }
+    }
+
+    // parse a quoted text after the opening '"', and append it to text
+    // Return false if the end of it is found before the closing '"'.
+    // Post condition: it.GetLocation() points to the next of the closing '"', the first location found an error, or the end of it.
+    template <typename INP, typename Sentinel, typename TextT>
+    bool PoParser::ParseTextBody(CharFeeder<INP, Sentinel> &it, TextT &text)
     {
-        std::string text;
         bool closed = false;
-        LocationT errorLoc = it.GetLocation();
+        auto errorPos = it.GetPosition();
         std::string errorMessage;
         bool error = false;
-        it.Next();
         while (it.IsNotEnd()) {
+            // Most of the text doesn't contain any escape sequence.
+            it.AppendPlainText(text);
+            if (it.IsEnd()) {
+                break;
+            }
             const char c = it.Get();
-            const LocationT loc = it.GetLocation();
+            const auto pos = it.GetPosition();
             it.Next();
             if (c == '"') {
                 closed = true;
@@ -472,13 +1084,13 @@ namespace spiritless_po {
             } else if (c == '\n') {
                 if (!error) {
                     errorMessage = "The text may not contain a newline.";
-                    errorLoc = loc;
+                    errorPos = pos;
                     error = true;
                 }
                 break;
             } else if (c == '\\') {
                 const char c2 = it.Get();
-                const LocationT loc2 = it.GetLocation();
+                const auto pos2 = it.GetPosition();
                 it.Next();
                 switch (c2) {
                 case 'a':
@@ -530,7 +1142,7 @@ namespace spiritless_po {
                 default:
                     if (!error) {
                         errorMessage = "Invalid escape sequence.";
-                        errorLoc = loc2;
+                        errorPos = pos2;
                         error = true;
                         // try to consume the input characters until '"' is found.
                     }
@@ -539,15 +1151,16 @@ namespace spiritless_po {
                 text += c;
             }
         }
-        if (!closed && !error) {
-            errorMessage = "Closing double quotation mark is expected.";
-            errorLoc = it.GetLocation();
-            error = true;
-        }
         if (error) {
-            throw PoParseError(errorMessage, errorLoc);
+            throw PoParseError(errorMessage, it.GetLocation(errorPos));
         }
-        return text;
+        return closed;
+    }
+
+    inline PoParser::TextSizeT &PoParser::TextSizeT::operator+=(char) noexcept
+    {
+        ++size;
+        return *this;
     }
 
     // parse a comment
@@ -567,7 +1180,7 @@ namespace spiritless_po {
                 switch (state) {
                 case 0:
                     // Skip white spaces and comma.
-                    if (std::isspace(c, std::locale::classic()) || c == ',') {
+                    if (IsSpace(c) || c == ',') {
                         it.Next();
                     } else {
                         state = 1;
@@ -575,7 +1188,7 @@ namespace spiritless_po {
                     break;
                 case 1:
                     // Check the flag.
-                    if (StartsWith(it, "fuzzy")) {
+                    if (it.StartsWith("fuzzy")) {
                         // It's a fuzzy if the next is the end or '\n'.
                         token = TokenT::FUZZY;
                         state = 2;
@@ -585,7 +1198,7 @@ namespace spiritless_po {
                     break;
                 case 2:
                     // Check if it is the end of "fuzzy".
-                    if (std::isspace(c, std::locale::classic()) || c == ',') {
+                    if (IsSpace(c) || c == ',') {
                         // No need to search it anymore.
                         state = 4;
                     } else {
@@ -597,7 +1210,7 @@ namespace spiritless_po {
                     break;
                 default:
                     // Skip until the next white space or comma.
-                    if (std::isspace(c, std::locale::classic()) || c == ',') {
+                    if (IsSpace(c) || c == ',') {
                         state = 0;
                     }
                     it.Next();
@@ -609,27 +1222,22 @@ namespace spiritless_po {
             }
         }
         // Skip until NL.
-        while (it.IsNotEnd()) {
-            const char c = it.Get();
-            it.Next();
-            if (c == '\n') {
-                break;
-            }
-        }
+        it.SkipToNewLine();
+        it.Next();
         return token;
     }
 
     // lexical analyzer
     // Post condition: it.GetLocation() points to the next location of the last fed character.
-    // loc is the location of token.
+    // pos is the position of token.
     // text for "text" when TEXT is returned.
     // n_msgstr for msgstr[n_msgstr] when MSGSTR_PLURAL is returned.
     // (n_msgstr is preserved when MSGSTR is returned)
     template <typename INP, typename Sentinel>
-    PoParser::TokenT PoParser::Lex(CharFeeder<INP, Sentinel> &it, LocationT &loc, std::string &text, std::size_t &n_msgstr)
+    PoParser::TokenT PoParser::Lex(CharFeeder<INP, Sentinel> &it, typename CharFeeder<INP, Sentinel>::PositionT &pos, std::string &text, std::size_t &n_msgstr)
     {
         SkipWhiteSpace(it);
-        loc = it.GetLocation();
+        pos = it.GetPosition();
         if (it.IsEnd()) {
             return TokenT::EOT;
         }
@@ -642,7 +1250,12 @@ namespace spiritless_po {
         } else if (c == 'm') {
             token = ParseMsgKeyword(it, n_msgstr);
         } else if (c == '"') {
-            text = ParseText(it);
+            text.clear();
+            {
+                SPIRITLESS_PO_LOAD_PROFILE_TIMER(parseText);
+                ParseText(it, text);
+            }
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(parseText, text.size(), 1);
             token = TokenT::TEXT;
         } else {
             throw PoParseError("Unknown token.", it.GetLocation());
@@ -650,191 +1263,880 @@ namespace spiritless_po {
         return token;
     }
 
-    inline PoParser::StateTransTable::StateTransTable() noexcept
+    // Lex a token in msgstr for the sink that doesn't decode msgstr.
+    // The text is decoded, because the iterator may not be able to read it again.
+    template <typename INP, typename Sentinel>
+    PoParser::TokenT PoParser::LexMsgstr(CharFeeder<INP, Sentinel> &it, typename CharFeeder<INP, Sentinel>::PositionT &pos, std::string &text, std::size_t &n_msgstr)
     {
-        // C++11 doesn't allow the for statement in the constexpr function...
+        return Lex(it, pos, text, n_msgstr);
+    }
 
-        for (std::size_t i = 0; i < static_cast<std::size_t>(StateT::TOTAL); ++i) {
-            for (std::size_t j = 0; j < static_cast<std::size_t>(TokenT::TOTAL); ++j) {
-                const StateT st = static_cast<StateT>(i);
-                const TokenT tk = static_cast<TokenT>(j);
-                if (tk == TokenT::COMMENT || tk == TokenT::FUZZY || tk == TokenT::MSGCTXT || tk == TokenT::MSGID || tk == TokenT::EOT) {
-                    // The token suggests the end of the current entry and the token is the start of the next entry.
-                    if ((StateT::MSGID <= st && st <= StateT::MSGSTR_PLURAL) || st == StateT::MSGID_TEXT || st == StateT::MSGID_PLURAL_TEXT || st == StateT::ERROR) {
-                        // The current entry is almost finished, but not completed.
-                        trans[i][j] = StateT::ABORT_ENTRY;
-                    } else if (st == StateT::MSGSTR_TEXT || st == StateT::MSGSTR_PLURAL_TEXT) {
-                        // The current entry is finished.
-                        trans[i][j] = StateT::END_OF_ENTRY;
-                    } else {
-                        // The token belongs to the current entry.
-                        trans[i][j] = StateT::ERROR_BEFORE_MSGID;
-                    }
-                } else if (st == StateT::ERROR || tk == TokenT::MSGID || tk == TokenT::MSGID_PLURAL || tk == TokenT::MSGSTR || tk == TokenT::MSGSTR_PLURAL) {
-                    // The next starting token belongs to the next entry.
-                    // Try to find the start token of the next entry to recover.
-                    trans[i][j] = StateT::ERROR;
-                } else {
-                    // The token belongs to the current entry.
-                    trans[i][j] = StateT::ERROR_BEFORE_MSGID;
-                }
-            }
+    // Lex a token in msgstr for the sink that doesn't decode msgstr.
+    // A text is only checked, and text is set to an empty text if the decoded text is empty, or a placeholder character otherwise.
+    inline PoParser::TokenT PoParser::LexMsgstr(CharFeeder<const char *, const char *> &it, const char *&pos, std::string &text, std::size_t &n_msgstr)
+    {
+        SkipWhiteSpace(it);
+        if (it.IsEnd() || it.Get() != '"') {
+            return Lex(it, pos, text, n_msgstr);
         }
+        pos = it.GetPosition();
+        TextSizeT size{ 0 };
+        {
+            SPIRITLESS_PO_LOAD_PROFILE_TIMER(parseText);
+            ParseText(it, size);
+        }
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(parseText, size.size, 1);
+        text.assign(size.size != 0 ? 1 : 0, ' ');
+        return TokenT::TEXT;
+    }
 
-        // transition table
-        constexpr struct {
-            StateT cur;
-            TokenT token;
-            StateT next;
-        } valid_def[] = {
-            {StateT::COMMENT, TokenT::COMMENT, StateT::COMMENT},
-            {StateT::COMMENT, TokenT::FUZZY, StateT::COMMENT},
-            {StateT::COMMENT, TokenT::MSGCTXT, StateT::MSGCTXT},
-            {StateT::COMMENT, TokenT::MSGID, StateT::MSGID},
-            {StateT::COMMENT, TokenT::EOT, StateT::EOT},
-            {StateT::MSGCTXT, TokenT::TEXT, StateT::MSGCTXT_TEXT},
-            {StateT::MSGCTXT_TEXT, TokenT::TEXT, StateT::MSGCTXT_TEXT},
-            {StateT::MSGCTXT_TEXT, TokenT::MSGID, StateT::MSGID},
-            {StateT::MSGID, TokenT::TEXT, StateT::MSGID_TEXT},
-            {StateT::MSGID, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGID_TEXT, TokenT::TEXT, StateT::MSGID_TEXT},
-            {StateT::MSGID_TEXT, TokenT::MSGID_PLURAL, StateT::MSGID_PLURAL},
-            {StateT::MSGID_TEXT, TokenT::MSGSTR, StateT::MSGSTR},
-            {StateT::MSGID_TEXT, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGID_PLURAL, TokenT::TEXT, StateT::MSGID_PLURAL_TEXT},
-            {StateT::MSGID_PLURAL, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGID_PLURAL_TEXT, TokenT::TEXT, StateT::MSGID_PLURAL_TEXT},
-            {StateT::MSGID_PLURAL_TEXT, TokenT::MSGSTR_PLURAL, StateT::MSGSTR_PLURAL},
-            {StateT::MSGID_PLURAL_TEXT, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGSTR, TokenT::TEXT, StateT::MSGSTR_TEXT},
-            {StateT::MSGSTR, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGSTR_TEXT, TokenT::TEXT, StateT::MSGSTR_TEXT},
-            {StateT::MSGSTR_TEXT, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGSTR_PLURAL, TokenT::TEXT, StateT::MSGSTR_PLURAL_TEXT},
-            {StateT::MSGSTR_PLURAL, TokenT::ERROR, StateT::ERROR},
-            {StateT::MSGSTR_PLURAL_TEXT, TokenT::TEXT, StateT::MSGSTR_PLURAL_TEXT},
-            {StateT::MSGSTR_PLURAL_TEXT, TokenT::MSGSTR_PLURAL, StateT::MSGSTR_PLURAL},
-            {StateT::MSGSTR_PLURAL_TEXT, TokenT::ERROR, StateT::ERROR},
-            {StateT::END_OF_ENTRY, TokenT::COMMENT, StateT::COMMENT},
-            {StateT::END_OF_ENTRY, TokenT::FUZZY, StateT::COMMENT},
-            {StateT::END_OF_ENTRY, TokenT::MSGCTXT, StateT::MSGCTXT},
-            {StateT::END_OF_ENTRY, TokenT::MSGID, StateT::MSGID},
-            {StateT::END_OF_ENTRY, TokenT::EOT, StateT::EOT},
-            {StateT::ABORT_ENTRY, TokenT::COMMENT, StateT::COMMENT},
-            {StateT::ABORT_ENTRY, TokenT::FUZZY, StateT::COMMENT},
-            {StateT::ABORT_ENTRY, TokenT::MSGCTXT, StateT::MSGCTXT},
-            {StateT::ABORT_ENTRY, TokenT::MSGID, StateT::MSGID},
-            {StateT::ABORT_ENTRY, TokenT::EOT, StateT::EOT},
-            {StateT::ERROR_BEFORE_MSGID, TokenT::EOT, StateT::ABORT_ENTRY},
+    inline PoParser::StateT PoParser::StateTransTable::GetState(const StateT state, const TokenT token) noexcept
+    {
+        // trans[the current state][the token] is the next state.
+        // END_OF_ENTRY and ABORT_ENTRY: The current entry is finished by the token, and the token is the start of the next entry.
+        // ERROR_BEFORE_MSGID: The token belongs to the current entry, but it is not expected.
+        // ERROR: Try to find the start token of the next entry to recover.
+        static constexpr StateT trans[static_cast<unsigned int>(StateT::TOTAL)][static_cast<unsigned int>(TokenT::TOTAL)] = {
+            // COMMENT, FUZZY, MSGCTXT, MSGID, MSGID_PLURAL, MSGSTR, MSGSTR_PLURAL, TEXT, ERROR, EOT
+            {StateT::COMMENT, StateT::COMMENT, StateT::MSGCTXT, StateT::MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::EOT}, // END_OF_ENTRY
+            {StateT::COMMENT, StateT::COMMENT, StateT::MSGCTXT, StateT::MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::EOT}, // ABORT_ENTRY
+            {StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ABORT_ENTRY}, // ERROR_BEFORE_MSGID
+            {StateT::COMMENT, StateT::COMMENT, StateT::MSGCTXT, StateT::MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::EOT}, // COMMENT
+            {StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGCTXT_TEXT, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID}, // MSGCTXT
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGID_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGID
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGID_PLURAL_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGID_PLURAL
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGSTR_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGSTR
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGSTR_PLURAL_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGSTR_PLURAL
+            {StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGCTXT_TEXT, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID}, // MSGCTXT_TEXT
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::MSGID_PLURAL, StateT::MSGSTR, StateT::ERROR, StateT::MSGID_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGID_TEXT
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::MSGSTR_PLURAL, StateT::MSGID_PLURAL_TEXT, StateT::ERROR, StateT::ABORT_ENTRY}, // MSGID_PLURAL_TEXT
+            {StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::MSGSTR_TEXT, StateT::ERROR, StateT::END_OF_ENTRY}, // MSGSTR_TEXT
+            {StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::END_OF_ENTRY, StateT::ERROR, StateT::ERROR, StateT::MSGSTR_PLURAL, StateT::MSGSTR_PLURAL_TEXT, StateT::ERROR, StateT::END_OF_ENTRY}, // MSGSTR_PLURAL_TEXT
+            {StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ABORT_ENTRY, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ABORT_ENTRY}, // ERROR
+            {StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR, StateT::ERROR, StateT::ERROR, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID, StateT::ERROR_BEFORE_MSGID}, // EOT
         };
-        for (const auto &it : valid_def) {
-            trans[static_cast<unsigned int>(it.cur)][static_cast<unsigned int>(it.token)] = it.next;
+        return trans[static_cast<unsigned int>(state)][static_cast<unsigned int>(token)];
+    }
+
+    inline PoParser::EntryListSink::EntryListSink()
+        : curEntry()
+    {
+    }
+
+    inline bool PoParser::EntryListSink::HasError() const noexcept
+    {
+        return !curEntry.error.empty();
+    }
+
+    inline void PoParser::EntryListSink::SetError(std::string message)
+    {
+        curEntry.error = std::move(message);
+    }
+
+    inline void PoParser::EntryListSink::AppendMsgid(OutputT &, std::string &text)
+    {
+        AppendText(curEntry.msgid, text);
+    }
+
+    inline void PoParser::EntryListSink::AppendMsgid(OutputT &, const char c)
+    {
+        curEntry.msgid += c;
+    }
+
+    inline void PoParser::EntryListSink::AppendMsgidPlural(OutputT &, std::string &text)
+    {
+        AppendText(curEntry.msgid_plural, text);
+    }
+
+    inline std::size_t PoParser::EntryListSink::GetMsgstrCount() const noexcept
+    {
+        return curEntry.msgstr.size();
+    }
+
+    template <typename PositionT>
+    void PoParser::EntryListSink::AddMsgstr(OutputT &, const PositionT &)
+    {
+        curEntry.msgstr.emplace_back("");
+    }
+
+    template <typename PositionT>
+    void PoParser::EntryListSink::AppendMsgstr(OutputT &, std::string &text, const PositionT &)
+    {
+        AppendText(curEntry.msgstr.back(), text);
+    }
+
+    inline void PoParser::EntryListSink::FinishEntry(OutputT &out, const bool fuzzy)
+    {
+        if (!curEntry.error.empty()) {
+            curEntry.msgid.clear();
+            curEntry.msgid_plural.clear();
+            curEntry.msgstr.clear();
+        } else if (fuzzy) {
+            curEntry.msgstr[0].clear();
         }
+        out.push_back(std::move(curEntry));
+        // initialize the new entry
+        curEntry.msgid.clear();
+        curEntry.msgid_plural.clear();
+        curEntry.msgstr.clear();
+        curEntry.error.clear();
     }
 
-    inline PoParser::StateT PoParser::StateTransTable::GetState(StateT state, TokenT token) const noexcept
+    // Append text to dest.
+    // Most of the strings consist of a single quoted text, so text is moved if dest is empty.
+    inline void PoParser::EntryListSink::AppendText(std::string &dest, std::string &text)
     {
-        return trans[static_cast<unsigned int>(state)][static_cast<unsigned int>(token)];
+        if (dest.empty()) {
+            dest.swap(text);
+        } else {
+            dest += text;
+        }
+    }
+
+    inline PoParser::EntryTableSink::EntryTableSink()
+        : error(), msgidSize(0), msgstrSize(0), msgstrCount(0)
+    {
+    }
+
+    inline bool PoParser::EntryTableSink::HasError() const noexcept
+    {
+        return !error.empty();
+    }
+
+    inline void PoParser::EntryTableSink::SetError(std::string message)
+    {
+        error = std::move(message);
+    }
+
+    inline void PoParser::EntryTableSink::AppendMsgid(OutputT &out, std::string &text)
+    {
+        out.text += text;
+        msgidSize += text.size();
+    }
+
+    inline void PoParser::EntryTableSink::AppendMsgid(OutputT &out, const char c)
+    {
+        out.text += c;
+        ++msgidSize;
+    }
+
+    inline void PoParser::EntryTableSink::AppendMsgidPlural(OutputT &, std::string &)
+    {
+    }
+
+    inline std::size_t PoParser::EntryTableSink::GetMsgstrCount() const noexcept
+    {
+        return msgstrCount;
+    }
+
+    template <typename PositionT>
+    void PoParser::EntryTableSink::AddMsgstr(OutputT &out, const PositionT &)
+    {
+        EntryTableT::RangeT range;
+        range.offset = out.text.size();
+        range.size = 0;
+        out.msgstrs.push_back(range);
+        ++msgstrCount;
+    }
+
+    template <typename PositionT>
+    void PoParser::EntryTableSink::AppendMsgstr(OutputT &out, std::string &text, const PositionT &)
+    {
+        out.text += text;
+        out.msgstrs.back().size += text.size();
+        msgstrSize += text.size();
+    }
+
+    inline void PoParser::EntryTableSink::FinishEntry(OutputT &out, const bool fuzzy)
+    {
+        EntryTableT::EntryT entry;
+        entry.msgid.offset = out.text.size() - msgidSize - msgstrSize;
+        entry.msgstrIndex = out.msgstrs.size() - msgstrCount;
+        entry.errorIndex = 0;
+        entry.flags = 0;
+        if (!error.empty()) {
+            // Drop the strings of the current entry.
+            out.text.resize(entry.msgid.offset);
+            out.msgstrs.resize(entry.msgstrIndex);
+            entry.msgid.size = 0;
+            entry.msgstrCount = 0;
+            entry.errorIndex = out.errors.size();
+            entry.flags = EntryTableT::FLAG_ERROR;
+            out.errors.push_back(std::move(error));
+        } else {
+            entry.msgid.size = msgidSize;
+            entry.msgstrCount = msgstrCount;
+            if (fuzzy) {
+                out.msgstrs[entry.msgstrIndex].size = 0;
+                entry.flags = EntryTableT::FLAG_FUZZY;
+            }
+        }
+        out.entries.push_back(entry);
+        // initialize the new entry
+        error.clear();
+        msgidSize = 0;
+        msgstrSize = 0;
+        msgstrCount = 0;
+    }
+
+    inline PoParser::IndexEntrySink::IndexEntrySink()
+        : curEntry{ std::string(), nullptr, nullptr, 0, true, std::string() }
+    {
+    }
+
+    inline bool PoParser::IndexEntrySink::HasError() const noexcept
+    {
+        return !curEntry.error.empty();
+    }
+
+    inline void PoParser::IndexEntrySink::SetError(std::string message)
+    {
+        curEntry.error = std::move(message);
+    }
+
+    inline void PoParser::IndexEntrySink::AppendMsgid(OutputT &, std::string &text)
+    {
+        if (curEntry.msgid.empty()) {
+            curEntry.msgid.swap(text);
+        } else {
+            curEntry.msgid += text;
+        }
+    }
+
+    inline void PoParser::IndexEntrySink::AppendMsgid(OutputT &, const char c)
+    {
+        curEntry.msgid += c;
+    }
+
+    inline void PoParser::IndexEntrySink::AppendMsgidPlural(OutputT &, std::string &)
+    {
+    }
+
+    inline std::size_t PoParser::IndexEntrySink::GetMsgstrCount() const noexcept
+    {
+        return curEntry.msgstrCount;
+    }
+
+    inline void PoParser::IndexEntrySink::AddMsgstr(OutputT &, const char *const pos)
+    {
+        if (curEntry.msgstrCount == 0) {
+            curEntry.msgstrBegin = pos;
+        }
+        ++curEntry.msgstrCount;
+    }
+
+    inline void PoParser::IndexEntrySink::AppendMsgstr(OutputT &, std::string &text, const char *const end)
+    {
+        if (curEntry.msgstrCount == 1 && !text.empty()) {
+            curEntry.isMsgstr0Empty = false;
+        }
+        curEntry.msgstrEnd = end;
+    }
+
+    inline void PoParser::IndexEntrySink::FinishEntry(OutputT &out, const bool fuzzy)
+    {
+        if (!curEntry.error.empty()) {
+            curEntry.msgid.clear();
+            curEntry.msgstrBegin = nullptr;
+            curEntry.msgstrEnd = nullptr;
+            curEntry.msgstrCount = 0;
+        } else if (fuzzy) {
+            curEntry.isMsgstr0Empty = true;
+        }
+        out.push_back(std::move(curEntry));
+        // initialize the new entry
+        curEntry.msgid.clear();
+        curEntry.msgstrBegin = nullptr;
+        curEntry.msgstrEnd = nullptr;
+        curEntry.msgstrCount = 0;
+        curEntry.isMsgstr0Empty = true;
+        curEntry.error.clear();
+    }
+
+    template <typename Sink>
+    PoParser::EntryBuilder<Sink>::EntryBuilder()
+        : state(StateT::END_OF_ENTRY), fuzzy(false), hasMsgctxt(false), sink()
+    {
+    }
+
+    template <typename Sink>
+    bool PoParser::EntryBuilder<Sink>::IsEnd() const noexcept
+    {
+        return state == StateT::EOT;
+    }
+
+    template <typename Sink>
+    bool PoParser::EntryBuilder<Sink>::IsAtEntryBoundary() const noexcept
+    {
+        return state == StateT::END_OF_ENTRY || state == StateT::MSGSTR_TEXT || state == StateT::MSGSTR_PLURAL_TEXT;
+    }
+
+    template <typename Sink>
+    bool PoParser::EntryBuilder<Sink>::IsInMsgstr() const noexcept
+    {
+        return state == StateT::MSGSTR || state == StateT::MSGSTR_PLURAL || state == StateT::MSGSTR_TEXT || state == StateT::MSGSTR_PLURAL_TEXT;
+    }
+
+    template <typename Sink>
+    void PoParser::EntryBuilder<Sink>::SetError(const std::string &message)
+    {
+        // Report only the error that causes an error.
+        if (!sink.HasError()) {
+            sink.SetError(message);
+        }
+    }
+
+    template <typename Sink>
+    template <typename Feeder>
+    bool PoParser::EntryBuilder<Sink>::Put(const TokenT token, const Feeder &it, const typename Feeder::PositionT &pos, std::string &text, const std::size_t n_msgstr, typename Sink::OutputT &out)
+    {
+        SPIRITLESS_PO_LOAD_PROFILE_TIMER(assemble);
+        state = StateTransTable::GetState(state, token);
+        if (state == StateT::END_OF_ENTRY || state == StateT::ABORT_ENTRY) {
+            if (state == StateT::ABORT_ENTRY && !sink.HasError()) {
+                // Report only the error that causes an error.
+                sink.SetError(it.GetLocation(pos).ToString() + "Unexpected " + GetTokenName(token) + " (the previous entry is incomplete).");
+            }
+            // register the current entry
+            sink.FinishEntry(out, fuzzy);
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(assemble, 0, 1);
+            fuzzy = false;
+            hasMsgctxt = false;
+            state = StateTransTable::GetState(state, token);
+        }
+        switch (state) {
+        case StateT::ERROR:
+        case StateT::ERROR_BEFORE_MSGID:
+            // Report only the error that causes an error.
+            if (!sink.HasError()) {
+                sink.SetError(it.GetLocation(pos).ToString() + "Unexpected " + GetTokenName(token) + '.');
+            }
+            // Try to recover lexical error
+            return token == TokenT::ERROR;
+        case StateT::COMMENT:
+            fuzzy |= token == TokenT::FUZZY;
+            break;
+        case StateT::MSGCTXT_TEXT:
+        case StateT::MSGID_TEXT:
+            sink.AppendMsgid(out, text);
+            break;
+        case StateT::MSGID_PLURAL_TEXT:
+            sink.AppendMsgidPlural(out, text);
+            break;
+        case StateT::MSGCTXT:
+            hasMsgctxt = true;
+            break;
+        case StateT::MSGID:
+            if (hasMsgctxt) {
+                sink.AppendMsgid(out, CONTEXT_SEPARATOR);
+                hasMsgctxt = false;
+            }
+            break;
+        case StateT::MSGSTR:
+        case StateT::MSGSTR_PLURAL:
+            if (n_msgstr != sink.GetMsgstrCount()) {
+                sink.SetError(it.GetLocation(pos).ToString() + "Invalid n in msgstr[n]; n should be " + std::to_string(sink.GetMsgstrCount()) + " but " + std::to_string(n_msgstr) + '.');
+                state = StateT::ERROR;
+            } else {
+                sink.AddMsgstr(out, pos);
+            }
+            break;
+        case StateT::MSGSTR_TEXT:
+        case StateT::MSGSTR_PLURAL_TEXT:
+            sink.AppendMsgstr(out, text, it.GetPosition());
+            break;
+        default:
+            // do nothing
+            break;
+        }
+        return false;
+    }
+
+    // Skip until NL. (Utility function)
+    // Post condition: it.GetLocation() points to '\n', or the end of it.
+    template <typename INP, typename Sentinel>
+    void PoParser::SkipToNewLine(CharFeeder<INP, Sentinel> &it)
+    {
+        it.SkipToNewLine();
     }
 
     // Parse all PO entries.
     template <typename INP, typename Sentinel>
     std::vector<PoParser::PoEntryT> PoParser::GetEntries(INP &&begin, Sentinel &&end)
     {
-        static const PoParser::StateTransTable transTable;
         std::vector<PoEntryT> entries;
+        Parse<EntryListSink>(begin, end, entries, IsContiguousCharRange<INP, Sentinel>());
+        return entries;
+    }
+
+    // Parse all PO entries into the columnar form.
+    template <typename INP, typename Sentinel>
+    PoParser::EntryTableT PoParser::GetEntryTable(INP &&begin, Sentinel &&end)
+    {
+        EntryTableT table;
+        Parse<EntryTableSink>(begin, end, table, IsContiguousCharRange<INP, Sentinel>());
+        return table;
+    }
+
+    // Parse all PO entries, without keeping msgstr.
+    inline std::vector<PoParser::IndexEntryT> PoParser::GetIndexEntries(const char *const begin, const char *const end)
+    {
+        std::vector<IndexEntryT> entries;
+        const char *cur = begin;
+        const char *last = end;
+        Parse<IndexEntrySink>(cur, last, entries, std::false_type());
+        return entries;
+    }
+
+    // Decode the msgstr block that has been checked by GetIndexEntries().
+    inline std::vector<std::string> PoParser::DecodeMsgstr(const char *const begin, const char *const end)
+    {
+        std::vector<std::string> msgstr;
+        const char *cur = begin;
+        const char *last = end;
+        CharFeeder<const char *, const char *> it(cur, last, LocationT());
+        std::string text;
+        try {
+            for (;;) {
+                const char *pos = cur;
+                std::size_t n_msgstr = 0;
+                const TokenT token = Lex(it, pos, text, n_msgstr);
+                if (token == TokenT::MSGSTR || token == TokenT::MSGSTR_PLURAL) {
+                    msgstr.emplace_back();
+                } else if (token == TokenT::TEXT && !msgstr.empty()) {
+                    msgstr.back() += text;
+                } else {
+                    break;
+                }
+            }
+        } catch (PoParseError &) {
+            // The block isn't the one checked by GetIndexEntries().
+        }
+        return msgstr;
+    }
+
+    // Parse all PO entries by the pointers.
+    // Post condition: begin points to the end of the parsed text.
+    template <typename Sink, typename INP, typename Sentinel>
+    void PoParser::Parse(INP &begin, Sentinel &end, typename Sink::OutputT &out, std::true_type)
+    {
+        const std::size_t size = end - begin;
+        const char *const first = size == 0 ? nullptr : &*begin;
+        const char *cur = first;
+        const char *last = first + size;
+        Parse<Sink>(cur, last, out, std::false_type());
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, cur - first, 0);
+        begin += cur - first;
+    }
+
+    // Parse all PO entries by the iterators.
+    template <typename Sink, typename INP, typename Sentinel>
+    void PoParser::Parse(INP &begin, Sentinel &end, typename Sink::OutputT &out, std::false_type)
+    {
         CharFeeder<INP, Sentinel> it(begin, end, LocationT());
-        StateT state = StateT::END_OF_ENTRY;
-        bool fuzzy = false;
-        bool hasMsgctxt = false;
-        PoEntryT curEntry;
+        EntryBuilder<Sink> builder;
         std::string text;
-        while (state != StateT::EOT) {
+        while (!builder.IsEnd()) {
             TokenT token = TokenT::ERROR;
-            LocationT loc;
+            typename CharFeeder<INP, Sentinel>::PositionT pos = it.GetPosition();
             std::size_t n_msgstr = 0;
             try {
-                token = PoParser::Lex(it, loc, text, n_msgstr);
+                SPIRITLESS_PO_LOAD_PROFILE_TIMER(lex);
+                if (Sink::DECODES_MSGSTR || !builder.IsInMsgstr()) {
+                    token = PoParser::Lex(it, pos, text, n_msgstr);
+                } else {
+                    token = PoParser::LexMsgstr(it, pos, text, n_msgstr);
+                }
+                SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, 0, 1);
             } catch (PoParseError &e) {
                 token = TokenT::ERROR;
-                if (curEntry.error.empty()) {
-                    // Report only the error that causes an error.
-                    const LocationT &eloc = e.GetLocation();
-                    curEntry.error = eloc.ToString() + e.what();
-                }
+                builder.SetError(e.GetLocation().ToString() + e.what());
             }
-            state = transTable.GetState(state, token);
-            if (state == StateT::END_OF_ENTRY || state == StateT::ABORT_ENTRY) {
-                if (state == StateT::ABORT_ENTRY && curEntry.error.empty()) {
-                    // Report only the error that causes an error.
-                    curEntry.error = loc.ToString() + "Unexpected " + GetTokenName(token) + " (the previous entry is incomplete).";
-                }
-                // register the current entry
-                if (!curEntry.error.empty()) {
-                    curEntry.msgid.clear();
-                    curEntry.msgstr.clear();
-                } else if (fuzzy) {
-                    curEntry.msgstr[0].clear();
-                }
-                entries.push_back(curEntry);
-                // initialize the new entry
-                curEntry.msgid.clear();
-                curEntry.msgstr.clear();
-                curEntry.error.clear();
-                fuzzy = false;
-                hasMsgctxt = false;
-                state = transTable.GetState(state, token);
+            if (builder.Put(token, it, pos, text, n_msgstr, out)) {
+                SkipToNewLine(it);
             }
-            switch (state) {
-            case StateT::ERROR:
-            case StateT::ERROR_BEFORE_MSGID:
-                // Report only the error that causes an error.
-                if (curEntry.error.empty()) {
-                    curEntry.error = loc.ToString() + "Unexpected " + GetTokenName(token) + '.';
-                }
-                if (token == TokenT::ERROR) {
-                    // Try to recover lexical error
-                    while (it.IsNotEnd() && it.Get() != '\n') {
-                        it.Next();
-                    }
+        }
+    }
+
+    inline PoParser::IncrementalParser::IncrementalParser()
+        : IncrementalParser(LocationT())
+    {
+    }
+
+    inline PoParser::IncrementalParser::IncrementalParser(const LocationT &startLoc)
+        : builder(), pending(), loc(startLoc), skipLine(false),
+          inText(false), textLoc(), textPrefix(), textError()
+    {
+    }
+
+    // The rest of the text is only white spaces and the finished tokens are at the boundary of the entries.
+    inline bool PoParser::IncrementalParser::IsAtEntryBoundary() const
+    {
+        for (const char c : pending) {
+            if (!IsSpace(c)) {
+                return false;
+            }
+        }
+        return !skipLine && !inText && builder.IsAtEntryBoundary();
+    }
+
+    inline std::vector<PoParser::PoEntryT> PoParser::IncrementalParser::Feed(const char *const data, const std::size_t size)
+    {
+        std::vector<PoEntryT> entries;
+        if (pending.empty()) {
+            // Parse the chunk directly, and keep only the unfinished part.
+            const char *const rest = Parse(data, data + size, false, entries);
+            pending.assign(rest, data + size);
+        } else {
+            pending.append(data, size);
+            const char *const rest = Parse(pending.data(), pending.data() + pending.size(), false, entries);
+            pending.erase(0, rest - pending.data());
+        }
+        if (inText && pending.size() > 4 && pending[0] == '\\' && pending[1] == 'x') {
+            // pending is "\xh..h", and only the last two digits are significant, so the long run isn't kept.
+            const std::size_t removed = pending.size() - 4;
+            loc.Next(pending.data() + 2, pending.data() + 2 + removed);
+            SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, removed, 0);
+            pending.erase(2, removed);
+        }
+        return entries;
+    }
+
+    inline std::vector<PoParser::PoEntryT> PoParser::IncrementalParser::Finish()
+    {
+        std::vector<PoEntryT> entries;
+        Parse(pending.data(), pending.data() + pending.size(), true, entries);
+        *this = IncrementalParser();
+        return entries;
+    }
+
+    // Parse the tokens that don't depend on the text after end, unless isLast is true.
+    // Return the beginning of the unparsed text.
+    inline const char *PoParser::IncrementalParser::Parse(const char *const begin, const char *const end, const bool isLast, std::vector<PoEntryT> &entries)
+    {
+        const char *cur = begin;
+        const char *endIt = end;
+        CharFeeder<const char *, const char *> it(cur, endIt, loc);
+        if (skipLine) {
+            SkipToNewLine(it);
+            loc = it.GetLocation();
+            if (it.IsEnd() && !isLast) {
+                return cur;
+            }
+            skipLine = false;
+        }
+        const char *parsed = cur;
+        if (inText) {
+            ParseLongText(it, endIt, isLast, entries);
+            parsed = cur;
+        }
+        std::string text;
+        while (!inText && !skipLine && !builder.IsEnd()) {
+            TokenT token = TokenT::ERROR;
+            const char *tokenPos = cur;
+            std::size_t n_msgstr = 0;
+            std::string error;
+            try {
+                SPIRITLESS_PO_LOAD_PROFILE_TIMER(lex);
+                token = PoParser::Lex(it, tokenPos, text, n_msgstr);
+                SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, 0, 1);
+            } catch (PoParseError &e) {
+                token = TokenT::ERROR;
+                error = e.GetLocation().ToString() + e.what();
+            }
+            if (it.IsEnd() && !isLast) {
+                // The token may continue in the next chunk.
+                // A quoted text is kept as the decoded text instead, so the next Feed() doesn't lex the long text again.
+                if (tokenPos != end && *tokenPos == '"' && FindTextCut(tokenPos + 1, end) != nullptr) {
+                    inText = true;
+                    textLoc = it.GetLocation(tokenPos);
+                    textPrefix.clear();
+                    textError.clear();
+                    cur = tokenPos + 1;
+                    ParseLongText(it, endIt, false, entries);
+                    parsed = cur;
                 }
                 break;
-            case StateT::COMMENT:
-                fuzzy |= token == TokenT::FUZZY;
-                break;
-            case StateT::MSGCTXT_TEXT:
-            case StateT::MSGID_TEXT:
-                curEntry.msgid += text;
+            }
+            if (!error.empty()) {
+                builder.SetError(error);
+            }
+            if (builder.Put(token, it, tokenPos, text, n_msgstr, entries)) {
+                SkipToNewLine(it);
+                skipLine = it.IsEnd() && !isLast;
+            }
+            parsed = cur;
+        }
+        loc = it.GetLocation(parsed);
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, parsed - begin, 0);
+        return parsed;
+    }
+
+    // Parse the quoted text that continues from the previous chunk, and put it as a token if it's finished.
+    // Return false if it continues in the next chunk.
+    inline bool PoParser::IncrementalParser::ParseLongText(CharFeeder<const char *, const char *> &it, const char *&endIt, const bool isLast, std::vector<PoEntryT> &entries)
+    {
+        const char *const end = endIt;
+        const char *const cut = isLast ? nullptr : FindTextCut(it.GetPosition(), end);
+        if (cut != nullptr) {
+            // The escape sequence at the end may continue in the next chunk.
+            endIt = cut;
+        }
+        bool closed = false;
+        try {
+            SPIRITLESS_PO_LOAD_PROFILE_TIMER(parseText);
+            closed = ParseTextBody(it, textPrefix);
+        } catch (PoParseError &e) {
+            // The text is consumed until the closing '"', and the first error is reported.
+            if (textError.empty()) {
+                textError = e.GetLocation().ToString() + e.what();
+            }
+        }
+        endIt = end;
+        if (cut != nullptr) {
+            return false;
+        }
+        if (!closed && textError.empty()) {
+            textError = it.GetLocation().ToString() + "Closing double quotation mark is expected.";
+        }
+
+        // Put the whole text as the token at the opening '"'.
+        inText = false;
+        const char *tokenIt = nullptr;
+        const char *tokenEnd = nullptr;
+        CharFeeder<const char *, const char *> tokenFeeder(tokenIt, tokenEnd, textLoc);
+        TokenT token = TokenT::TEXT;
+        if (!textError.empty()) {
+            builder.SetError(textError);
+            token = TokenT::ERROR;
+        }
+        std::string text;
+        text.swap(textPrefix);
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(parseText, text.size(), 1);
+        SPIRITLESS_PO_LOAD_PROFILE_COUNT(lex, 0, 1);
+        if (builder.Put(token, tokenFeeder, tokenIt, text, 0, entries)) {
+            SkipToNewLine(it);
+            skipLine = it.IsEnd() && !isLast;
+        }
+        textError.clear();
+        return true;
+    }
+
+    // Find the end of the part of a quoted text that can be decoded before end.
+    // Return nullptr if the text is finished by '"' or '\n' before end.
+    inline const char *PoParser::IncrementalParser::FindTextCut(const char *const begin, const char *const end)
+    {
+        const char *p = begin;
+        const char *escape = nullptr;
+        for (;;) {
+            p = FindTextDelimiter(p, end);
+            if (p == end) {
                 break;
-            case StateT::MSGCTXT:
-                hasMsgctxt = true;
+            }
+            if (*p != '\\') {
+                return nullptr;
+            }
+            escape = p;
+            if (end - p <= 2) {
                 break;
-            case StateT::MSGID:
-                if (hasMsgctxt) {
-                    curEntry.msgid += CONTEXT_SEPARATOR;
-                    hasMsgctxt = false;
+            }
+            p += 2;
+        }
+        if (escape != nullptr) {
+            // "\", "\c", and "\cc" may continue, and "\ooo" is the longest octal escape sequence.
+            if (end - escape <= 3) {
+                return escape;
+            }
+            // The length of "\xh..h" is unlimited.
+            if (escape[1] == 'x') {
+                const char *q = escape + 2;
+                while (q != end && IsXDigit(*q)) {
+                    ++q;
                 }
-                break;
-            case StateT::MSGSTR:
-            case StateT::MSGSTR_PLURAL:
-                if (n_msgstr != curEntry.msgstr.size()) {
-                    curEntry.error = loc.ToString() + "Invalid n in msgstr[n]; n should be " + std::to_string(curEntry.msgstr.size()) + " but " + std::to_string(n_msgstr) + '.';
-                    state = StateT::ERROR;
-                } else {
-                    curEntry.msgstr.emplace_back("");
+                if (q == end) {
+                    return escape;
                 }
+            }
+        }
+        return end;
+    }
+
+    // Find the beginning of an entry after a blank line. (Utility function)
+    // Return the beginning of "#", "msgctxt", or "msgid" at the column 1, or end if it's not found.
+    inline const char *PoParser::FindEntryBoundary(const char *const begin, const char *const end)
+    {
+        // A quoted text cannot contain '\n', so the beginning of a line is out of the quoted text.
+        const char *p = begin;
+        for (;;) {
+            p = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (p == nullptr) {
+                return end;
+            }
+            ++p;
+            while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                ++p;
+            }
+            if (p == end || *p != '\n') {
+                continue;
+            }
+            const char *const line = p + 1;
+            const std::size_t len = end - line;
+            if ((len >= 1 && line[0] == '#')
+                || (len >= 7 && std::memcmp(line, "msgctxt", 7) == 0)
+                || (len >= 5 && std::memcmp(line, "msgid", 5) == 0 && (len == 5 || line[5] != '_'))) {
+                return line;
+            }
+        }
+    }
+
+    // Find the first '"', '\\', or '\n'. (Utility function)
+    // Return end if it's not found.
+    inline const char *PoParser::FindTextDelimiter(const char *const begin, const char *const end) noexcept
+    {
+        const char *p = begin;
+#if defined(SPIRITLESS_PO_PO_PARSER_USE_AVX2)
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        while (end - p >= 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)), _mm256_cmpeq_epi8(v, newline));
+            const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(m));
+            if (mask != 0) {
+#ifdef _MSC_VER
+                unsigned long idx;
+                _BitScanForward(&idx, mask);
+                return p + idx;
+#else
+                return p + __builtin_ctz(mask);
+#endif
+            }
+            p += 32;
+        }
+#elif defined(SPIRITLESS_PO_PO_PARSER_USE_SSE2)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), _mm_cmpeq_epi8(v, newline));
+            const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(m));
+            if (mask != 0) {
+#ifdef _MSC_VER
+                unsigned long idx;
+                _BitScanForward(&idx, mask);
+                return p + idx;
+#else
+                return p + __builtin_ctz(mask);
+#endif
+            }
+            p += 16;
+        }
+#endif
+        while (p != end && *p != '"' && *p != '\\' && *p != '\n') {
+            ++p;
+        }
+        return p;
+    }
+
+    // Parse all PO entries on some threads.
+    inline PoParser::ChunkedParser::ChunkedParser(const char *const begin, const char *const end, const unsigned int threads)
+        : bounds(1, begin), startLocs(1, LocationT()), results()
+    {
+        // Too small chunks don't pay for the threads.
+        const std::size_t minChunkSize = 1024 * 1024;
+        const std::size_t textSize = end - begin;
+        const std::size_t nChunks = std::max<std::size_t>(std::min<std::size_t>(threads, textSize / minChunkSize), 1);
+
+        // Split the text at the beginnings of the entries.
+        for (std::size_t i = 1; i < nChunks; ++i) {
+            const char *const target = begin + textSize / nChunks * i;
+            const char *const bound = FindEntryBoundary(std::max(target, bounds.back()), end);
+            if (bound == end) {
                 break;
-            case StateT::MSGSTR_TEXT:
-            case StateT::MSGSTR_PLURAL_TEXT:
-                curEntry.msgstr.back() += text;
-                break;
-            default:
-                // do nothing
-                break;
             }
+            bounds.push_back(bound);
+        }
+        bounds.push_back(end);
+        const std::size_t n = bounds.size() - 1;
+
+        // The first line number of each chunk.
+        std::vector<std::future<std::size_t>> lineCounts;
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            lineCounts.push_back(std::async(std::launch::async, [this, i]() -> std::size_t {
+                return std::count(bounds[i], bounds[i + 1], '\n');
+            }));
+        }
+        for (auto &count : lineCounts) {
+            startLocs.emplace_back(startLocs.back().GetLine() + count.get());
+        }
+        results.resize(n);
+    }
+
+    inline std::size_t PoParser::ChunkedParser::GetChunkCount() const noexcept
+    {
+        return results.size();
+    }
+
+    // Parse a chunk as if it's at the beginning of the text.
+    inline void PoParser::ChunkedParser::Parse(const std::size_t i)
+    {
+        ChunkResultT &result = results[i];
+        if (results.size() == 1) {
+            const char *it = bounds[0];
+            const char *endIt = bounds[1];
+            result.entries = PoParser::GetEntries(it, endIt);
+            result.isClean = true;
+            return;
+        }
+        IncrementalParser parser(startLocs[i]);
+        result.entries = parser.Feed(bounds[i], bounds[i + 1] - bounds[i]);
+        result.isClean = parser.IsAtEntryBoundary();
+        std::vector<PoEntryT> rest(parser.Finish());
+        result.entries.insert(result.entries.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+    }
+
+    // Merge the results in the order of the text.
+    // If a chunk doesn't end at the boundary of the entries, the next chunks depend on it, so they are parsed serially.
+    inline std::vector<PoParser::PoEntryT> PoParser::ChunkedParser::GetEntries()
+    {
+        std::vector<PoEntryT> entries;
+        const std::size_t n = results.size();
+        std::size_t i = 0;
+        while (i < n) {
+            if (results[i].isClean || i + 1 == n) {
+                entries.insert(entries.end(), std::make_move_iterator(results[i].entries.begin()), std::make_move_iterator(results[i].entries.end()));
+                ++i;
+                continue;
+            }
+            IncrementalParser parser(startLocs[i]);
+            do {
+                std::vector<PoEntryT> newEntries(parser.Feed(bounds[i], bounds[i + 1] - bounds[i]));
+                entries.insert(entries.end(), std::make_move_iterator(newEntries.begin()), std::make_move_iterator(newEntries.end()));
+                ++i;
+            } while (i < n && !parser.IsAtEntryBoundary());
+            std::vector<PoEntryT> rest(parser.Finish());
+            entries.insert(entries.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
         }
         return entries;
     }
+
+    inline std::vector<PoParser::PoEntryT> PoParser::GetEntriesParallel(const char *const begin, const char *const end, unsigned int threads)
+    {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        ChunkedParser parser(begin, end, threads);
+        std::vector<std::future<void>> futures;
+        for (std::size_t i = 1; i < parser.GetChunkCount(); ++i) {
+            futures.push_back(std::async(std::launch::async, [&parser, i]() { parser.Parse(i); }));
+        }
+        parser.Parse(0);
+        for (auto &f : futures) {
+            f.get();
+        }
+        return parser.GetEntries();
+    }
 } // namespace spiritless_po
 
 #endif // SPIRITLESS_PO_PO_PARSER_H_
@@ -0,0 +1,334 @@
+/** class PoWriter
+    \file PoWriter.h
+    \author OOTA, Masato
+    \copyright Copyright © 2026 OOTA, Masato
+    \par License Boost
+    \parblock
+      This program is distributed under the Boost Software License Version 1.0.
+      You can get the license file at “https://www.boost.org/LICENSE_1_0.txt”.
+    \endparblock
+*/
+
+#ifndef SPIRITLESS_PO_PO_WRITER_H_
+#define SPIRITLESS_PO_PO_WRITER_H_
+
+#include "Catalog.h"
+#include "Common.h"
+#include "PoParser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spiritless_po {
+    /** This class writes the PO entries as a PO text.
+
+        The text is made in a buffer, and it's written into the stream by the large blocks.
+
+        - msgid that contains CONTEXT_SEPARATOR is written as msgctxt and msgid.
+        - An entry that has msgid_plural or more than one msgstr is written as msgid_plural and msgstr[n]. msgid_plural is an empty string if it isn't given.
+        - An entry that has no msgstr is written with an empty msgstr.
+        - A text that contains '\\n' is written in some lines, which are split after each '\\n'.
+        - The characters that cannot be written in a quoted text are escaped, and the other control characters are written as the octal escape sequence.
+    */
+    class PoWriter {
+    public:
+        /** Type of the options. */
+        struct OptionsT {
+            /** Create the default options. */
+            OptionsT();
+
+            std::size_t wrapWidth; /**< The maximum width of a quoted line, including the double quotation marks, or 0 not to wrap the lines. A line is wrapped after a space, so a line that has no space may be longer. */
+        };
+
+        /** Create a writer.
+            \param [in] os The stream to write the PO text.
+            \param [in] options The options.
+            \attention The stream must outlive the instance.
+        */
+        explicit PoWriter(std::ostream &os, const OptionsT &options = OptionsT());
+
+        /** This class is uncopyable. */
+        PoWriter(const PoWriter &) = delete;
+
+        /** This class is unassignable. */
+        PoWriter &operator=(const PoWriter &) = delete;
+
+        /** Write the rest of the text into the stream.
+            \note An error of the stream is ignored. Call Flush() before the destruction to get the error from the stream.
+        */
+        ~PoWriter();
+
+        /** Write an entry.
+            \param [in] entry The entry from PoParser.
+            \note Nothing is written if the entry has an error.
+            \note The entry is written as msgid_plural and msgstr[n] if entry.msgid_plural isn't empty or entry.msgstr has more than one msgstr.
+        */
+        void Write(const PoParser::PoEntryT &entry);
+
+        /** Write an entry.
+            \param [in] msgid msgid (msgctxt + CONTEXT_SEPARATOR + msgid if msgctxt exists.)
+            \param [in] msgstr msgstr, or msgstr[n] if the size is more than 1.
+            \note msgid_plural of the entry that has more than one msgstr is an empty string. Use Write(msgid, msgid_plural, msgstr) to write msgid_plural.
+        */
+        void Write(const std::string &msgid, const std::vector<std::string> &msgstr);
+
+        /** Write an entry that has msgid_plural.
+            \param [in] msgid msgid (msgctxt + CONTEXT_SEPARATOR + msgid if msgctxt exists.)
+            \param [in] msgid_plural msgid_plural.
+            \param [in] msgstr msgstr[n].
+        */
+        void Write(const std::string &msgid, const std::string &msgid_plural, const std::vector<std::string> &msgstr);
+
+        /** Write all the entries in a catalog.
+            \param [in] catalog The catalog to write.
+            \note The metadata is written first, and the other entries are written in the order of Catalog::IndexDataT::stringTableIndex, that is the order of the addition.
+            \attention The output is lossy. Catalog doesn't keep msgid_plural, so an entry that has more than one msgstr is written with an empty msgid_plural, and an entry that has only msgstr[0] is written as msgstr. Reading the output makes the same catalog, but the output isn't the original PO text.
+        */
+        void Write(const Catalog &catalog);
+
+        /** Write the buffered text into the stream, and flush the stream. */
+        void Flush();
+
+    private:
+        // The buffered text is written when it's larger than this size.
+        static constexpr std::size_t bufferSize = 64 * 1024;
+
+        void WriteEntry(const std::string &msgid, const std::string &msgidPlural, bool hasPlural, const std::string *msgstr, std::size_t count);
+        void AppendText(const char *keyword, const char *begin, const char *end);
+        void AppendEscaped(const char *begin, const char *end);
+        void WriteBuffer();
+
+        std::ostream &stream;
+        OptionsT options;
+        std::string buffer;
+        bool isFirst;
+        // Work area for AppendText().
+        std::string escaped;
+        std::vector<std::pair<std::size_t, bool>> breaks;
+        std::vector<std::size_t> lineEnds;
+    };
+
+    inline PoWriter::OptionsT::OptionsT()
+        : wrapWidth(0)
+    {
+    }
+
+    inline PoWriter::PoWriter(std::ostream &os, const OptionsT &options)
+        : stream(os), options(options), buffer(), isFirst(true), escaped(), breaks(), lineEnds()
+    {
+        buffer.reserve(bufferSize + 4 * 1024);
+    }
+
+    inline PoWriter::~PoWriter()
+    {
+        try {
+            WriteBuffer();
+        } catch (...) {
+            // The stream may throw an exception, but a destructor cannot throw it.
+        }
+    }
+
+    inline void PoWriter::Write(const PoParser::PoEntryT &entry)
+    {
+        if (entry.error.empty()) {
+            WriteEntry(entry.msgid, entry.msgid_plural, !entry.msgid_plural.empty(), entry.msgstr.data(), entry.msgstr.size());
+        }
+    }
+
+    inline void PoWriter::Write(const std::string &msgid, const std::vector<std::string> &msgstr)
+    {
+        WriteEntry(msgid, std::string(), false, msgstr.data(), msgstr.size());
+    }
+
+    inline void PoWriter::Write(const std::string &msgid, const std::string &msgid_plural, const std::vector<std::string> &msgstr)
+    {
+        WriteEntry(msgid, msgid_plural, true, msgstr.data(), msgstr.size());
+    }
+
+    inline void PoWriter::Write(const Catalog &catalog)
+    {
+        typedef std::pair<const std::string, Catalog::IndexDataT> IndexT;
+        std::vector<const IndexT *> entries;
+        entries.reserve(catalog.GetIndex().size());
+        for (const auto &it : catalog.GetIndex()) {
+            entries.push_back(&it);
+        }
+        std::sort(entries.begin(), entries.end(), [](const IndexT *a, const IndexT *b) {
+            // The metadata is the first.
+            if (a->first.empty() != b->first.empty()) {
+                return a->first.empty();
+            }
+            return a->second.stringTableIndex < b->second.stringTableIndex;
+        });
+        const std::vector<std::string> &stringTable = catalog.GetStringTable();
+        for (const IndexT *it : entries) {
+            WriteEntry(it->first, std::string(), false, stringTable.data() + it->second.stringTableIndex, it->second.totalPlurals);
+        }
+    }
+
+    inline void PoWriter::Flush()
+    {
+        WriteBuffer();
+        stream.flush();
+    }
+
+    // The entry is written as msgid_plural and msgstr[n] if hasPlural is true or it has more than one msgstr.
+    inline void PoWriter::WriteEntry(const std::string &msgid, const std::string &msgidPlural, const bool hasPlural, const std::string *const msgstr, const std::size_t count)
+    {
+        if (!isFirst) {
+            buffer += '\n';
+        }
+        isFirst = false;
+        const char *const idBegin = msgid.data();
+        const char *const idEnd = idBegin + msgid.size();
+        const char *const separator = std::find(idBegin, idEnd, CONTEXT_SEPARATOR);
+        if (separator != idEnd) {
+            AppendText("msgctxt", idBegin, separator);
+            AppendText("msgid", separator + 1, idEnd);
+        } else {
+            AppendText("msgid", idBegin, idEnd);
+        }
+        const char *const empty = "";
+        if (!hasPlural && count <= 1) {
+            if (count == 1) {
+                AppendText("msgstr", msgstr[0].data(), msgstr[0].data() + msgstr[0].size());
+            } else {
+                AppendText("msgstr", empty, empty);
+            }
+        } else {
+            AppendText("msgid_plural", msgidPlural.data(), msgidPlural.data() + msgidPlural.size());
+            if (count == 0) {
+                AppendText("msgstr[0]", empty, empty);
+            }
+            std::string keyword;
+            for (std::size_t i = 0; i < count; ++i) {
+                keyword = "msgstr[" + std::to_string(i) + ']';
+                AppendText(keyword.c_str(), msgstr[i].data(), msgstr[i].data() + msgstr[i].size());
+            }
+        }
+        if (buffer.size() >= bufferSize) {
+            WriteBuffer();
+        }
+    }
+
+    // Append 'keyword "text"\n', or 'keyword ""\n' and the lines of the text.
+    inline void PoWriter::AppendText(const char *const keyword, const char *const begin, const char *const end)
+    {
+        escaped.clear();
+        breaks.clear();
+        AppendEscaped(begin, end);
+
+        // Split the text after '\n' (must), or after ' ' (may) if the line is too long.
+        lineEnds.clear();
+        std::size_t lineStart = 0;
+        std::size_t candidate = 0;
+        breaks.emplace_back(escaped.size(), true);
+        for (const auto &b : breaks) {
+            const std::size_t pos = b.first;
+            if (options.wrapWidth > 0 && pos - lineStart + 2 > options.wrapWidth && candidate > lineStart) {
+                lineEnds.push_back(candidate);
+                lineStart = candidate;
+            }
+            if (b.second) {
+                if (pos > lineStart || lineEnds.empty()) {
+                    lineEnds.push_back(pos);
+                }
+                lineStart = pos;
+            }
+            candidate = pos;
+        }
+
+        buffer += keyword;
+        if (lineEnds.size() == 1) {
+            buffer += " \"";
+            buffer += escaped;
+            buffer += "\"\n";
+        } else {
+            buffer += " \"\"\n";
+            std::size_t start = 0;
+            for (const std::size_t lineEnd : lineEnds) {
+                buffer += '"';
+                buffer.append(escaped, start, lineEnd - start);
+                buffer += "\"\n";
+                start = lineEnd;
+            }
+        }
+    }
+
+    // Append the escaped text to escaped, and the positions to split the lines to breaks.
+    inline void PoWriter::AppendEscaped(const char *const begin, const char *const end)
+    {
+        const bool wrap = options.wrapWidth > 0;
+        const char *p = begin;
+        while (p != end) {
+            // The plain characters are appended at once.
+            const char *q = p;
+            while (q != end && static_cast<unsigned char>(*q) >= 0x20 && *q != '"' && *q != '\\' && (*q != ' ' || !wrap)) {
+                ++q;
+            }
+            escaped.append(p, q);
+            if (q == end) {
+                break;
+            }
+            const char c = *q;
+            p = q + 1;
+            switch (c) {
+            case ' ':
+                escaped += ' ';
+                breaks.emplace_back(escaped.size(), false);
+                break;
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                if (p != end) {
+                    breaks.emplace_back(escaped.size(), true);
+                }
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\a':
+                escaped += "\\a";
+                break;
+            case '\b':
+                escaped += "\\b";
+                break;
+            case '\f':
+                escaped += "\\f";
+                break;
+            case '\v':
+                escaped += "\\v";
+                break;
+            default: {
+                // The other control characters.
+                const unsigned char u = static_cast<unsigned char>(c);
+                const char octal[] = { '\\', static_cast<char>('0' + (u >> 6)), static_cast<char>('0' + ((u >> 3) & 7)), static_cast<char>('0' + (u & 7)) };
+                escaped.append(octal, sizeof(octal));
+                break;
+            }
+            }
+        }
+    }
+
+    inline void PoWriter::WriteBuffer()
+    {
+        if (!buffer.empty()) {
+            stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+} // namespace spiritless_po
+
+#endif // SPIRITLESS_PO_PO_WRITER_H_
@@ -0,0 +1,165 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// The replacement of the global operator new and operator delete that counts the allocations.
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "AllocationCounter.h"
+
+namespace {
+    std::atomic<std::size_t> allocations(0);
+    std::atomic<std::size_t> deallocations(0);
+    std::atomic<std::size_t> bytes(0);
+    std::atomic<std::size_t> liveBytes(0);
+    std::atomic<std::size_t> peakBytes(0);
+
+    // The size of the block is kept before the block, and the block keeps the alignment of malloc().
+    union HeaderT {
+        std::size_t size;
+        std::max_align_t align;
+    };
+
+    void *allocate(std::size_t size) noexcept
+    {
+        HeaderT *const header = static_cast<HeaderT *>(std::malloc(sizeof(HeaderT) + size));
+        if (header == nullptr) {
+            return nullptr;
+        }
+        header->size = size;
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        const std::size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        std::size_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        return header + 1;
+    }
+
+    void *allocate_or_throw(std::size_t size)
+    {
+        for (;;) {
+            void *const p = allocate(size);
+            if (p != nullptr) {
+                return p;
+            }
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void deallocate(void *p) noexcept
+    {
+        if (p == nullptr) {
+            return;
+        }
+        HeaderT *const header = static_cast<HeaderT *>(p) - 1;
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+        std::free(header);
+    }
+}
+
+namespace alloc_counter {
+    CountsT GetCounts() noexcept
+    {
+        CountsT counts;
+        counts.allocations = allocations.load(std::memory_order_relaxed);
+        counts.deallocations = deallocations.load(std::memory_order_relaxed);
+        counts.bytes = bytes.load(std::memory_order_relaxed);
+        counts.peakBytes = peakBytes.load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    std::size_t GetLiveBytes() noexcept
+    {
+        return liveBytes.load(std::memory_order_relaxed);
+    }
+
+    void ResetPeak() noexcept
+    {
+        peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    std::size_t GetPeakRss() noexcept
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#ifdef __APPLE__
+        // ru_maxrss is in bytes on macOS.
+        return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+        // ru_maxrss is in kilobytes on Linux and BSD.
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+} // namespace alloc_counter
+
+void *operator new(std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    deallocate(p);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+#endif
@@ -0,0 +1,71 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// Counters of the dynamic memory allocations for the tests and the benchmarks.
+// AllocationCounter.cpp replaces the global operator new and operator delete with the counting hooks, so it must be linked into the test program.
+
+#ifndef SPIRITLESS_PO_TEST_ALLOCATION_COUNTER_H_
+#define SPIRITLESS_PO_TEST_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace alloc_counter {
+    // Counts of the allocations.
+    struct CountsT {
+        std::size_t allocations; // The number of the calls of operator new.
+        std::size_t deallocations; // The number of the calls of operator delete, except for nullptr.
+        std::size_t bytes; // The total size of the allocated memory.
+        std::size_t peakBytes; // The peak size of the memory that is allocated and not deallocated yet.
+    };
+
+    // Get the counts since the start of the program.
+    // peakBytes is the peak since the last ResetPeak().
+    CountsT GetCounts() noexcept;
+
+    // Get the size of the memory that is allocated and not deallocated yet.
+    std::size_t GetLiveBytes() noexcept;
+
+    // Set the peak to the current live bytes.
+    void ResetPeak() noexcept;
+
+    // Get the peak resident set size of the process in bytes, or 0 if it's not supported.
+    std::size_t GetPeakRss() noexcept;
+
+    // The counts in a scope.
+    // The allocations on all the threads are counted.
+    class ScopeT {
+    public:
+        ScopeT() noexcept;
+
+        // Get the counts since the construction.
+        // peakBytes is the peak of the increase of the live bytes since the construction.
+        CountsT Get() const noexcept;
+
+    private:
+        CountsT start;
+        std::size_t startLiveBytes;
+    };
+
+    inline ScopeT::ScopeT() noexcept
+        : start(), startLiveBytes(0)
+    {
+        ResetPeak();
+        start = GetCounts();
+        startLiveBytes = GetLiveBytes();
+    }
+
+    inline CountsT ScopeT::Get() const noexcept
+    {
+        const CountsT now = GetCounts();
+        CountsT counts;
+        counts.allocations = now.allocations - start.allocations;
+        counts.deallocations = now.deallocations - start.deallocations;
+        counts.bytes = now.bytes - start.bytes;
+        counts.peakBytes = now.peakBytes > startLiveBytes ? now.peakBytes - startLiveBytes : 0;
+        return counts;
+    }
+} // namespace alloc_counter
+
+#endif // SPIRITLESS_PO_TEST_ALLOCATION_COUNTER_H_
@@ -0,0 +1,47 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+#include <catch2/catch_test_macros.hpp>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "BenchmarkRunner.h"
+
+using namespace std;
+
+TEST_CASE( "bench_runner::Runner", "[BenchmarkRunner]" ) {
+    bench_runner::OptionsT options;
+    options.samples = 3;
+    options.minSampleTime = 0.0001;
+    options.filter = "run";
+    bench_runner::Runner runner(options);
+    runner.Run("run \"allocation\"", { { "size", "100" } }, []() {
+        // A new-expression may be optimized away, but a call of operator new isn't.
+        void *const p = ::operator new(100);
+        ::operator delete(p);
+        return p != nullptr;
+    });
+    runner.Run("skipped", {}, []() {
+        return 1;
+    });
+
+    const auto &results = runner.GetResults();
+    REQUIRE( results.size() == 1 );
+    const auto &r = results[0];
+    REQUIRE( r.name == "run \"allocation\"" );
+    REQUIRE( r.parameters.size() == 1 );
+    REQUIRE( r.samples == 3 );
+    REQUIRE( r.iterations >= 1 );
+    REQUIRE( r.mean > 0 );
+    REQUIRE( r.allocations == 1.0 );
+    REQUIRE( r.bytes == 100.0 );
+
+    ostringstream os;
+    runner.WriteJson(os);
+    const string json = os.str();
+    REQUIRE( json.find("{\"name\": \"run \\\"allocation\\\"\", \"parameters\": {\"size\": \"100\"}, \"samples\": 3, ") != string::npos );
+    REQUIRE( json.find("\"allocations\": 1.000, \"bytes\": 100.000}") != string::npos );
+}
@@ -0,0 +1,206 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// A small benchmark runner that writes the results in JSON, for the comparison between the runs by bench_compare.
+// The allocations are counted by AllocationCounter.cpp, so it must be linked into the program.
+
+#ifndef SPIRITLESS_PO_TEST_BENCHMARK_RUNNER_H_
+#define SPIRITLESS_PO_TEST_BENCHMARK_RUNNER_H_
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AllocationCounter.h"
+
+namespace bench_runner {
+    // The parameters of a benchmark, such as the corpus options.
+    typedef std::vector<std::pair<std::string, std::string>> ParametersT;
+
+    // Options of the runner.
+    struct OptionsT {
+        OptionsT();
+
+        std::size_t samples; // The number of the samples.
+        double minSampleTime; // The minimum time of a sample in seconds. The iterations per sample are increased to reach it.
+        std::string filter; // Run only the benchmarks whose names contain it.
+    };
+
+    // A result of a benchmark.
+    struct ResultT {
+        std::string name;
+        ParametersT parameters;
+        std::size_t samples; // The number of the samples.
+        std::size_t iterations; // The iterations per sample.
+        double mean; // The mean time of an iteration in nanoseconds.
+        double stddev; // The standard deviation of the time of an iteration in nanoseconds.
+        double allocations; // The number of the allocations per iteration.
+        double bytes; // The allocated bytes per iteration.
+    };
+
+    // The runner.
+    class Runner {
+    public:
+        explicit Runner(const OptionsT &options = OptionsT());
+
+        // Run func() as a benchmark, unless the name is filtered out.
+        // func must return a value that depends on the work, so that the work isn't optimized away.
+        template <typename F>
+        void Run(const std::string &name, const ParametersT &parameters, F func);
+
+        const std::vector<ResultT> &GetResults() const noexcept;
+
+        // Write the results in JSON.
+        void WriteJson(std::ostream &os) const;
+
+    private:
+        template <typename F>
+        double Measure(F &func, std::size_t iterations);
+
+        OptionsT options;
+        std::vector<ResultT> results;
+    };
+
+    // Write a string in JSON.
+    void WriteJsonString(std::ostream &os, const std::string &s);
+
+    inline OptionsT::OptionsT()
+        : samples(20), minSampleTime(0.01), filter()
+    {
+    }
+
+    inline Runner::Runner(const OptionsT &options)
+        : options(options), results()
+    {
+    }
+
+    template <typename F>
+    void Runner::Run(const std::string &name, const ParametersT &parameters, F func)
+    {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            return;
+        }
+
+        // Increase the iterations per sample until a sample is long enough. It also warms up.
+        std::size_t iterations = 1;
+        while (Measure(func, iterations) < options.minSampleTime && iterations < (static_cast<std::size_t>(1) << 30)) {
+            iterations *= 2;
+        }
+
+        std::vector<double> times;
+        for (std::size_t i = 0; i < options.samples; ++i) {
+            times.push_back(Measure(func, iterations) * 1e9 / static_cast<double>(iterations));
+        }
+        double sum = 0;
+        for (const double t : times) {
+            sum += t;
+        }
+        const double mean = sum / static_cast<double>(times.size());
+        double squares = 0;
+        for (const double t : times) {
+            squares += (t - mean) * (t - mean);
+        }
+        const double stddev = times.size() > 1 ? std::sqrt(squares / static_cast<double>(times.size() - 1)) : 0.0;
+
+        // The allocations are counted in an extra sample, so they don't include the allocations by the runner.
+        const alloc_counter::ScopeT scope;
+        Measure(func, iterations);
+        const alloc_counter::CountsT counts = scope.Get();
+
+        ResultT result;
+        result.name = name;
+        result.parameters = parameters;
+        result.samples = times.size();
+        result.iterations = iterations;
+        result.mean = mean;
+        result.stddev = stddev;
+        result.allocations = static_cast<double>(counts.allocations) / static_cast<double>(iterations);
+        result.bytes = static_cast<double>(counts.bytes) / static_cast<double>(iterations);
+        results.push_back(result);
+    }
+
+    // Return the seconds of the iterations.
+    template <typename F>
+    double Runner::Measure(F &func, const std::size_t iterations)
+    {
+        std::size_t sum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            sum += static_cast<std::size_t>(func());
+        }
+        const auto end = std::chrono::steady_clock::now();
+        volatile std::size_t dummy = sum;
+        (void)dummy;
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    inline const std::vector<ResultT> &Runner::GetResults() const noexcept
+    {
+        return results;
+    }
+
+    inline void Runner::WriteJson(std::ostream &os) const
+    {
+        os << "{\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const ResultT &r = results[i];
+            os << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+            WriteJsonString(os, r.name);
+            os << ", \"parameters\": {";
+            for (std::size_t j = 0; j < r.parameters.size(); ++j) {
+                if (j > 0) {
+                    os << ", ";
+                }
+                WriteJsonString(os, r.parameters[j].first);
+                os << ": ";
+                WriteJsonString(os, r.parameters[j].second);
+            }
+            char numbers[256];
+            std::snprintf(numbers, sizeof(numbers),
+                "}, \"samples\": %zu, \"iterations\": %zu, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"allocations\": %.3f, \"bytes\": %.3f}",
+                r.samples, r.iterations, r.mean, r.stddev, r.allocations, r.bytes);
+            os << numbers;
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    inline void WriteJsonString(std::ostream &os, const std::string &s)
+    {
+        os << '"';
+        for (const char c : s) {
+            switch (c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                    os << escaped;
+                } else {
+                    os << c;
+                }
+                break;
+            }
+        }
+        os << '"';
+    }
+} // namespace bench_runner
+
+#endif // SPIRITLESS_PO_TEST_BENCHMARK_RUNNER_H_
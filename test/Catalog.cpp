@@ -4,12 +4,36 @@
   See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
 */
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "spiritless_po.h"
+#include "AllocationCounter.h"
+#include "PoCorpusGenerator.h"
+
+#ifdef SPIRITLESS_PO_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+#include <zstd.h>
+#endif
 
 using namespace std;
 using namespace spiritless_po;
@@ -400,6 +424,45 @@ TEST_CASE( "Catalog::Add(is)", "[Catalog]" ) {
 }
 
 
+namespace {
+    // The text that is larger than the blocks to read, and that contains some errors.
+    string gen_large_text()
+    {
+        string text(test_data);
+        for (int i = 0; text.size() < 300 * 1000; ++i) {
+            text += "\nmsgid \"key" + to_string(i) + "\"\nmsgstr \"" + string(i % 100, 'v') + "\"\n";
+            if (i % 1000 == 0) {
+                text += "msgid \"error" + to_string(i) + "\"\n";
+            }
+        }
+        return text;
+    }
+
+    // The errors aren't compared.
+    void check_same_entries(const Catalog &catalog, const Catalog &expected)
+    {
+        REQUIRE( catalog.GetMetadata() == expected.GetMetadata() );
+        REQUIRE( equal(catalog.GetIndex(), expected.GetIndex()) );
+        REQUIRE( catalog.GetStringTable() == expected.GetStringTable() );
+        REQUIRE( equal(catalog.GetStatistics(), expected.GetStatistics()) );
+    }
+
+    void check_same_catalog(const Catalog &catalog, const Catalog &expected)
+    {
+        check_same_entries(catalog, expected);
+        REQUIRE( catalog.GetError() == expected.GetError() );
+    }
+}
+
+TEST_CASE( "Catalog::Add(is) with the text larger than a block", "[Catalog]" ) {
+    const string text(gen_large_text());
+    Catalog expected(text.begin(), text.end());
+    Catalog catalog;
+    istringstream is(text);
+    REQUIRE( !catalog.Add(is) );
+    check_same_catalog(catalog, expected);
+}
+
 TEST_CASE( "Catalog::Merge()", "[Catalog]" ) {
     Catalog catalog(test_data.begin(), test_data.end());
     Catalog catalog2(test_data_2.begin(), test_data_2.end());
@@ -820,3 +883,778 @@ msgstr[3] "A3"
     REQUIRE( catalog.ngettext("a", "as", 4) == "A0" );
     REQUIRE( catalog.ngettext("a", "as", 5) == "A1" );
 }
+
+TEST_CASE( "Catalog::IncrementalAdder", "[Catalog]" ) {
+    for (size_t chunkSize = 1; chunkSize <= test_data.size(); chunkSize += 7) {
+        Catalog catalog;
+        Catalog::IncrementalAdder adder(catalog);
+        for (size_t i = 0; i < test_data.size(); i += chunkSize) {
+            adder.Feed(test_data.data() + i, min(chunkSize, test_data.size() - i));
+        }
+        REQUIRE( !adder.Finish() );
+
+        Catalog expected(test_data.begin(), test_data.end());
+        check_same_catalog(catalog, expected);
+    }
+}
+
+TEST_CASE( "Catalog::AddParallel()", "[Catalog]" ) {
+    string po_text;
+    while (po_text.size() < 3 * 1024 * 1024) {
+        po_text += test_data_2;
+        po_text += '\n';
+        po_text += test_data;
+    }
+    Catalog catalog;
+    catalog.AddParallel(po_text.data(), po_text.data() + po_text.size(), 4);
+    Catalog expected(po_text.begin(), po_text.end());
+    check_same_catalog(catalog, expected);
+}
+
+namespace {
+    // The files are removed at the end of the scope.
+    class TemporaryFiles {
+    public:
+        explicit TemporaryFiles(const vector<string> &contents)
+        {
+            for (size_t i = 0; i < contents.size(); ++i) {
+                const string path = "test_spiritless_po_" + to_string(i) + ".po";
+                ofstream f(path, ios::binary);
+                f << contents[i];
+                paths.push_back(path);
+            }
+        }
+        ~TemporaryFiles()
+        {
+            for (const auto &path : paths) {
+                remove(path.c_str());
+            }
+        }
+
+        vector<string> paths;
+    };
+
+    void check_add_files(const Catalog::AddFilesOptionsT &options)
+    {
+        TemporaryFiles files({ test_data, test_data_2, test_data });
+        vector<string> paths(files.paths);
+        paths.insert(paths.begin() + 1, "not_existed.po");
+        Catalog catalog;
+        REQUIRE( !catalog.AddFiles(paths, options) );
+
+        Catalog expected;
+        expected.Add(test_data.begin(), test_data.end());
+        expected.Add(test_data_2.begin(), test_data_2.end());
+        expected.Add(test_data.begin(), test_data.end());
+        check_same_entries(catalog, expected);
+        REQUIRE( catalog.GetError().size() == 5 );
+        REQUIRE( catalog.GetError()[0] == paths[0] + ": 40,1: Unexpected EOT (the previous entry is incomplete)." );
+        REQUIRE( catalog.GetError()[1] == "not_existed.po: Can't open the file." );
+        REQUIRE( catalog.GetError()[2].find(paths[2] + ": ") == 0 );
+        REQUIRE( catalog.GetError()[4].find(paths[3] + ": ") == 0 );
+    }
+}
+
+TEST_CASE( "Catalog::AddFiles()", "[Catalog]" ) {
+    SECTION( "default" ) {
+        check_add_files(Catalog::AddFilesOptionsT());
+    }
+    SECTION( "threads" ) {
+        Catalog::AddFilesOptionsT options;
+        options.threads = 2;
+        check_add_files(options);
+    }
+    SECTION( "executor" ) {
+        vector<future<void>> futures;
+        Catalog::AddFilesOptionsT options;
+        options.executor = [&futures](function<void()> task) { futures.push_back(async(launch::async, task)); };
+        check_add_files(options);
+    }
+    SECTION( "inline executor" ) {
+        Catalog::AddFilesOptionsT options;
+        options.executor = [](function<void()> task) { task(); };
+        check_add_files(options);
+    }
+}
+
+TEST_CASE( "Catalog::AddFiles() with a large file", "[Catalog]" ) {
+    // The large file is split into the chunks.
+    string po_text;
+    while (po_text.size() < 3 * 1024 * 1024) {
+        po_text += test_data_2;
+        po_text += '\n';
+        po_text += test_data;
+    }
+    TemporaryFiles files({ test_data_2, po_text, test_data });
+    Catalog expected;
+    expected.Add(test_data_2.begin(), test_data_2.end());
+    expected.Add(po_text.begin(), po_text.end());
+    expected.Add(test_data.begin(), test_data.end());
+    vector<string> expectedErrors(expected.GetError());
+    size_t k = 0;
+    for (size_t i = 0; i < files.paths.size(); ++i) {
+        Catalog one;
+        one.AddFile(files.paths[i].c_str());
+        for (size_t n = 0; n < one.GetError().size(); ++n, ++k) {
+            expectedErrors[k].insert(0, files.paths[i] + ": ");
+        }
+    }
+    REQUIRE( k == expectedErrors.size() );
+
+    SECTION( "threads" ) {
+        Catalog::AddFilesOptionsT options;
+        options.threads = 4;
+        Catalog catalog;
+        REQUIRE( !catalog.AddFiles(files.paths, options) );
+        check_same_entries(catalog, expected);
+        REQUIRE( catalog.GetError() == expectedErrors );
+    }
+    SECTION( "executor" ) {
+        vector<future<void>> futures;
+        Catalog::AddFilesOptionsT options;
+        options.threads = 4;
+        options.executor = [&futures](function<void()> task) { futures.push_back(async(launch::async, task)); };
+        Catalog catalog;
+        REQUIRE( !catalog.AddFiles(files.paths, options) );
+        check_same_entries(catalog, expected);
+        REQUIRE( catalog.GetError() == expectedErrors );
+    }
+}
+
+TEST_CASE( "Catalog::AddFile()", "[Catalog]" ) {
+    TemporaryFiles files({ "", test_data, test_data_2 });
+    Catalog catalog;
+    REQUIRE( catalog.AddFile(files.paths[0].c_str()) );
+    REQUIRE( !catalog.AddFile(files.paths[1].c_str()) );
+    REQUIRE( !catalog.AddFile(files.paths[2].c_str()) );
+
+    Catalog expected;
+    expected.Add(test_data.begin(), test_data.end());
+    expected.Add(test_data_2.begin(), test_data_2.end());
+    check_same_catalog(catalog, expected);
+
+    REQUIRE( !catalog.AddFile("not_existed.po") );
+    REQUIRE( catalog.GetError().back() == "Can't open the file." );
+}
+
+namespace {
+    // Check that the header is the same as the catalog.
+    void check_header(const Catalog::HeaderT &header, const Catalog &expected)
+    {
+        REQUIRE( header.metadata == expected.GetMetadata() );
+        REQUIRE( header.errors == expected.GetError() );
+        for (unsigned long n = 0; n < 200; ++n) {
+            REQUIRE( header.pluralFunction(n) == PluralParser::Parse("n%10==1 && n%100!=11 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2")(n) );
+        }
+    }
+}
+
+TEST_CASE( "Catalog::ScanHeader()", "[Catalog]" ) {
+    const string header_text = R"(# comment
+msgid ""
+msgstr ""
+"Language: ru\n"
+"Plural-Forms: nplurals=3; plural=n%10==1 && n%100!=11 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2;\n"
+)";
+    const string text = header_text + "\n" + gen_large_text();
+    const Catalog expected(header_text.begin(), header_text.end());
+
+    istringstream is(text);
+    const Catalog::HeaderT header = Catalog::ScanHeader(is);
+    check_header(header, expected);
+    REQUIRE( header.metadata.at("Language") == "ru" );
+    REQUIRE( header.maxPlurals == 2 );
+    // The rest of the stream isn't read.
+    REQUIRE( is.tellg() < 64 * 1024 );
+
+    TemporaryFiles files({ text, header_text, "msgid \"a\"\nmsgstr \"A\"\n\nmsgid \"\"\nmsgstr \"Language: ru\\n\"\n", "msgid \"\"\nmsgstr[x] \"\"\n\nmsgid \"\"\nmsgstr \"Plural-Forms: nplurals=0;\\n\"\n" });
+    check_header(Catalog::ScanHeader(files.paths[0].c_str()), expected);
+    check_header(Catalog::ScanHeader(files.paths[1].c_str()), expected);
+
+    // Only the first entry is the metadata.
+    const Catalog::HeaderT notMetadata = Catalog::ScanHeader(files.paths[2].c_str());
+    REQUIRE( notMetadata.metadata.empty() );
+    REQUIRE( notMetadata.errors.empty() );
+    REQUIRE( notMetadata.maxPlurals == 0 );
+
+    // The errors before the metadata are reported.
+    const Catalog::HeaderT withErrors = Catalog::ScanHeader(files.paths[3].c_str());
+    REQUIRE( withErrors.metadata.size() == 1 );
+    REQUIRE( withErrors.errors.size() == 2 );
+    REQUIRE( withErrors.errors[1] == "nplurals must be more than 0; ignored." );
+    REQUIRE( withErrors.maxPlurals == 0 );
+
+    REQUIRE( Catalog::ScanHeader("not_existed.po").errors == vector<string>{ "Can't open the file." } );
+}
+
+namespace {
+#ifdef SPIRITLESS_PO_USE_ZLIB
+    string compress_gzip(const string &text)
+    {
+        z_stream zs = {};
+        REQUIRE( deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK );
+        string result(deflateBound(&zs, static_cast<uLong>(text.size())), '\0');
+        zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+        zs.avail_in = static_cast<uInt>(text.size());
+        zs.next_out = reinterpret_cast<Bytef *>(&result[0]);
+        zs.avail_out = static_cast<uInt>(result.size());
+        REQUIRE( deflate(&zs, Z_FINISH) == Z_STREAM_END );
+        result.resize(zs.total_out);
+        deflateEnd(&zs);
+        return result;
+    }
+#endif
+
+#ifdef SPIRITLESS_PO_USE_ZSTD
+    string compress_zstd(const string &text)
+    {
+        string result(ZSTD_compressBound(text.size()), '\0');
+        const size_t size = ZSTD_compress(&result[0], result.size(), text.data(), text.size(), 3);
+        REQUIRE( !ZSTD_isError(size) );
+        result.resize(size);
+        return result;
+    }
+#endif
+
+    // Check AddFile(), Add(is), and AddFiles() for the compressed text.
+    void check_compressed(const string &compressed, const string &text)
+    {
+        Catalog expected(text.begin(), text.end());
+        TemporaryFiles files({ compressed });
+
+        Catalog fromFile;
+        fromFile.AddFile(files.paths[0].c_str());
+        check_same_catalog(fromFile, expected);
+
+        Catalog fromStream;
+        istringstream is(compressed);
+        fromStream.Add(is);
+        check_same_catalog(fromStream, expected);
+
+        Catalog fromFiles;
+        fromFiles.AddFiles(files.paths);
+        REQUIRE( fromFiles.GetError().size() == expected.GetError().size() );
+        REQUIRE( equal(fromFiles.GetIndex(), expected.GetIndex()) );
+    }
+
+    // Check that the broken compressed text causes the error.
+    void check_compressed_error(const string &compressed, const string &message)
+    {
+        TemporaryFiles files({ compressed });
+
+        Catalog fromFile;
+        REQUIRE( !fromFile.AddFile(files.paths[0].c_str()) );
+        REQUIRE( fromFile.GetError().back() == message );
+
+        Catalog fromStream;
+        istringstream is(compressed);
+        REQUIRE( !fromStream.Add(is) );
+        REQUIRE( fromStream.GetError().back() == message );
+
+        Catalog fromFiles;
+        REQUIRE( !fromFiles.AddFiles(files.paths) );
+        REQUIRE( fromFiles.GetError().back() == files.paths[0] + ": " + message );
+    }
+}
+
+TEST_CASE( "Compressed PO text", "[Catalog]" ) {
+    const string text(gen_large_text());
+#ifdef SPIRITLESS_PO_USE_ZLIB
+    SECTION( "gzip" ) {
+        const string compressed(compress_gzip(text));
+        check_compressed(compressed, text);
+        check_compressed(compressed + compress_gzip(test_data_2), text + test_data_2);
+        check_compressed_error(compressed.substr(0, compressed.size() - 4), "gzip: Unexpected end of the compressed data.");
+        check_compressed_error("\x1F\x8B", "gzip: Unexpected end of the compressed data.");
+        check_compressed_error(string("\x1F\x8B\x00\x00", 4), "gzip: unknown compression method");
+    }
+#else
+    SECTION( "gzip" ) {
+        check_compressed_error("\x1F\x8B\x08", "gzip is not supported.");
+    }
+#endif
+#ifdef SPIRITLESS_PO_USE_ZSTD
+    SECTION( "zstd" ) {
+        const string compressed(compress_zstd(text));
+        check_compressed(compressed, text);
+        check_compressed(compressed + compress_zstd(test_data_2), text + test_data_2);
+        check_compressed_error(compressed.substr(0, compressed.size() - 4), "zstd: Unexpected end of the compressed data.");
+    }
+#else
+    SECTION( "zstd" ) {
+        check_compressed_error("\x28\xB5\x2F\xFD", "zstd is not supported.");
+    }
+#endif
+}
+
+TEST_CASE( "Catalog lookup doesn't allocate memory", "[Catalog]" ) {
+    // A plural function by a lookup table, and an interpreted one. n / 10 isn't periodic, so it isn't made into a table.
+    for (const string plural : { "n != 1", "n / 10 % 10 == 1" }) {
+        const string text = "msgid \"\"\nmsgstr \"Plural-Forms: nplurals=3; plural=" + plural + ";\\n\"\n\n"
+            "msgid \"apple\"\nmsgstr \"APPLE\"\n\n"
+            "msgid \"a long message that doesn't fit in the small string buffer\"\nmsgstr \"A LONG MESSAGE\"\n\n"
+            "msgid \"file\"\nmsgid_plural \"files\"\nmsgstr[0] \"FILE0\"\nmsgstr[1] \"FILE1\"\nmsgstr[2] \"FILE2\"\n";
+        const Catalog catalog(text.begin(), text.end());
+        REQUIRE( catalog.GetError().empty() );
+        const string apple("apple");
+        const string longMessage("a long message that doesn't fit in the small string buffer");
+        const string missing("a missing message that doesn't fit in the small string buffer");
+        const string file("file");
+        const string files("files");
+
+        size_t sum = 0;
+        const alloc_counter::ScopeT scope;
+        sum += catalog.gettext(apple).size();
+        sum += catalog.gettext(longMessage).size();
+        sum += catalog.gettext(missing).size();
+        for (unsigned long n = 0; n < 30; ++n) {
+            sum += catalog.ngettext(file, files, n).size();
+            sum += catalog.ngettext(missing, files, n).size();
+        }
+        const alloc_counter::CountsT counts = scope.Get();
+        CHECK( sum > 0 );
+        CHECK( counts.allocations == 0 );
+        CHECK( counts.bytes == 0 );
+    }
+}
+
+
+// For some reason, "g++ -D_GLIBCXX_DEBUG" causes some errors in BENCHMARK()...
+#ifdef ENABLE_BENCHMARK
+namespace {
+    // A corpus to load.
+    struct LoadCorpusT {
+        string name;
+        string text;
+        size_t entries;
+    };
+
+    LoadCorpusT gen_load_corpus(const string &name, const po_corpus::OptionsT &options)
+    {
+        po_corpus::PoCorpusGenerator generator(options);
+        LoadCorpusT corpus;
+        corpus.name = name;
+        corpus.text = generator.Generate();
+        corpus.entries = generator.GetCounts().entries;
+        return corpus;
+    }
+
+    // The corpora of some sizes and shapes.
+    vector<LoadCorpusT> gen_load_corpora()
+    {
+        vector<LoadCorpusT> corpora;
+        po_corpus::OptionsT options;
+        options.entries = 1000;
+        corpora.push_back(gen_load_corpus("1k entries", options));
+        options.entries = 50000;
+        corpora.push_back(gen_load_corpus("50k entries", options));
+        po_corpus::OptionsT shortText(options);
+        shortText.minLength = 2;
+        shortText.meanLength = 8;
+        shortText.maxLength = 16;
+        shortText.commentRatio = 0.0;
+        corpora.push_back(gen_load_corpus("50k short entries", shortText));
+        po_corpus::OptionsT longText(options);
+        longText.entries = 10000;
+        longText.minLength = 100;
+        longText.meanLength = 400;
+        longText.maxLength = 2000;
+        corpora.push_back(gen_load_corpus("10k long entries", longText));
+        po_corpus::OptionsT complex(options);
+        complex.nplurals = 3;
+        complex.escapeRatio = 0.3;
+        complex.contextRatio = 0.5;
+        complex.pluralRatio = 0.5;
+        complex.fuzzyRatio = 0.1;
+        corpora.push_back(gen_load_corpus("50k plural/context/escape entries", complex));
+        return corpora;
+    }
+
+    // A stream buffer that reads the memory without copying.
+    class MemoryBuffer : public streambuf {
+    public:
+        MemoryBuffer(const char *begin, const char *end)
+        {
+            char *const p = const_cast<char *>(begin);
+            setg(p, p, p + (end - begin));
+        }
+    };
+
+    // Report the best throughput of some runs of func, which loads corpus.
+    template <typename F>
+    void report_throughput(const string &name, const LoadCorpusT &corpus, F func)
+    {
+        double best = numeric_limits<double>::max();
+        for (int i = 0; i < 5; ++i) {
+            const auto start = chrono::steady_clock::now();
+            func();
+            const auto end = chrono::steady_clock::now();
+            best = min(best, chrono::duration<double>(end - start).count());
+        }
+        cout << name << " [" << corpus.name << "]: "
+             << fixed << setprecision(0) << corpus.entries / best << " entries/s, "
+             << setprecision(1) << corpus.text.size() / best / 1e6 << " MB/s" << endl;
+    }
+}
+
+TEST_CASE( "Catalog Load Benchmark", "[!benchmark]" ) {
+    for (const auto &corpus : gen_load_corpora()) {
+        const string &text = corpus.text;
+        auto add_stream = [&text]() {
+            MemoryBuffer buf(text.data(), text.data() + text.size());
+            istream is(&buf);
+            Catalog catalog;
+            catalog.Add(is);
+            return catalog.GetIndex().size();
+        };
+        auto add_string = [&text]() {
+            Catalog catalog;
+            catalog.Add(text.begin(), text.end());
+            return catalog.GetIndex().size();
+        };
+        auto add_pointer = [&text]() {
+            Catalog catalog;
+            catalog.Add(text.data(), text.data() + text.size());
+            return catalog.GetIndex().size();
+        };
+        const Catalog source(text.begin(), text.end());
+        auto merge = [&source]() {
+            Catalog catalog;
+            catalog.Merge(source);
+            return catalog.GetIndex().size();
+        };
+
+        BENCHMARK( "Add(is) " + corpus.name ) {
+            return add_stream();
+        };
+        BENCHMARK( "Add(string::iterator) " + corpus.name ) {
+            return add_string();
+        };
+        BENCHMARK( "Add(const char *) " + corpus.name ) {
+            return add_pointer();
+        };
+        BENCHMARK( "Merge() " + corpus.name ) {
+            return merge();
+        };
+
+        report_throughput("Add(is)", corpus, add_stream);
+        report_throughput("Add(string::iterator)", corpus, add_string);
+        report_throughput("Add(const char *)", corpus, add_pointer);
+        report_throughput("Merge()", corpus, merge);
+    }
+}
+
+namespace {
+    // A set of the keys in a catalog for the lookup benchmark.
+    struct LookupKeySetT {
+        string name;
+        vector<string> keys; // The keys in the catalog.
+        vector<string> missingKeys; // The keys not in the catalog.
+    };
+
+    // Make a catalog that has the keys as msgid, and the keys in the context "menu", with the plural forms.
+    Catalog gen_lookup_catalog(const vector<string> &keys, const string &plural)
+    {
+        string text = "msgid \"\"\nmsgstr \"Plural-Forms: nplurals=3; plural=" + plural + ";\\n\"\n";
+        for (const auto &key : keys) {
+            const string entry = "msgid \"" + key + "\"\nmsgid_plural \"" + key + "s\"\nmsgstr[0] \"T0 " + key + "\"\nmsgstr[1] \"T1\"\nmsgstr[2] \"T2\"\n";
+            text += "\n" + entry + "\nmsgctxt \"menu\"\n" + entry;
+        }
+        return Catalog(text.begin(), text.end());
+    }
+
+    // Make the keys that fall into a few buckets of the index of gen_lookup_catalog().
+    // A catalog that has the same number of the keys has the same buckets, so every 16th bucket has about 16 keys.
+    void gen_same_bucket_keys(LookupKeySetT &keySet, const vector<string> &otherKeys)
+    {
+        const Catalog reference = gen_lookup_catalog(otherKeys, "n != 1");
+        const auto &index = reference.GetIndex();
+        for (size_t i = 0; keySet.keys.size() < otherKeys.size() || keySet.missingKeys.size() < otherKeys.size(); ++i) {
+            const string key = "b" + to_string(i);
+            const string missingKey = "x" + to_string(i);
+            if (keySet.keys.size() < otherKeys.size() && index.bucket(key) % 16 == 0) {
+                keySet.keys.push_back(key);
+            }
+            if (keySet.missingKeys.size() < otherKeys.size() && index.bucket(missingKey) % 16 == 0) {
+                keySet.missingKeys.push_back(missingKey);
+            }
+        }
+    }
+
+    vector<LookupKeySetT> gen_lookup_key_sets(size_t n)
+    {
+        vector<LookupKeySetT> keySets(4);
+        keySets[0].name = "short";
+        keySets[1].name = "long";
+        // The keys share a long prefix, so hashing and comparing a key takes more time.
+        keySets[2].name = "common-prefix";
+        // The keys collide in the buckets of the index, so gettext() and ngettext() walk a long chain. The keys with the context don't collide.
+        keySets[3].name = "same-bucket";
+        mt19937_64 engine(1);
+        const string prefix(256, 'p');
+        for (size_t i = 0; i < n; ++i) {
+            const string id = to_string(i);
+            keySets[0].keys.push_back("k" + id);
+            keySets[0].missingKeys.push_back("m" + id);
+            string longKey;
+            while (longKey.size() < 200) {
+                longKey += "word" + to_string(engine() % 1000) + ' ';
+            }
+            keySets[1].keys.push_back(longKey + id);
+            keySets[1].missingKeys.push_back(longKey + "missing" + id);
+            keySets[2].keys.push_back(prefix + id);
+            keySets[2].missingKeys.push_back(prefix + "m" + id);
+        }
+        gen_same_bucket_keys(keySets[3], keySets[0].keys);
+        return keySets;
+    }
+
+
+    // Make the sequence of the indexes of the keys to look up.
+    // zipf == 0 means the uniform popularity.
+    vector<size_t> gen_lookup_sequence(size_t nKeys, size_t length, double zipf, uint64_t seed)
+    {
+        mt19937_64 engine(seed);
+        vector<size_t> sequence(length);
+        if (zipf == 0) {
+            for (auto &i : sequence) {
+                i = static_cast<size_t>(engine() % nKeys);
+            }
+            return sequence;
+        }
+        vector<double> cdf(nKeys);
+        double sum = 0;
+        for (size_t k = 0; k < nKeys; ++k) {
+            sum += 1.0 / pow(static_cast<double>(k + 1), zipf);
+            cdf[k] = sum;
+        }
+        // The popular keys are scattered in the catalog.
+        vector<size_t> rankToKey(nKeys);
+        for (size_t k = 0; k < nKeys; ++k) {
+            rankToKey[k] = k;
+        }
+        shuffle(rankToKey.begin(), rankToKey.end(), engine);
+        for (auto &i : sequence) {
+            const double u = static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0) * sum;
+            const size_t rank = static_cast<size_t>(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+            i = rankToKey[rank < nKeys ? rank : nKeys - 1];
+        }
+        return sequence;
+    }
+
+    // Run lookup(thread index, key index) for each sequence on the threads at the same time, and return the seconds.
+    template <typename F>
+    double run_lookup_threads(const vector<vector<size_t>> &sequences, F lookup)
+    {
+        atomic<size_t> ready(0);
+        atomic<bool> go(false);
+        vector<thread> threads;
+        for (size_t t = 0; t < sequences.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                ++ready;
+                while (!go) {
+                    this_thread::yield();
+                }
+                size_t sum = 0;
+                for (const size_t i : sequences[t]) {
+                    sum += lookup(i);
+                }
+                volatile size_t dummy = sum;
+                (void)dummy;
+            });
+        }
+        while (ready < sequences.size()) {
+            this_thread::yield();
+        }
+        const auto start = chrono::steady_clock::now();
+        go = true;
+        for (auto &th : threads) {
+            th.join();
+        }
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST_CASE( "Catalog Lookup Benchmark", "[!benchmark]" ) {
+    const size_t nKeys = 10000;
+    const size_t lookupsPerThread = 200000;
+    const vector<LookupKeySetT> keySets = gen_lookup_key_sets(nKeys);
+    vector<unsigned int> threadCounts;
+    const unsigned int maxThreads = max(2U, thread::hardware_concurrency());
+    for (unsigned int t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+    const string context("menu");
+    const string plural("plural");
+
+    // Machine readable output: a CSV line per run.
+    cout << "lookup,function,keys,workload,plural,threads,lookups,seconds,lookups_per_second" << endl;
+    for (const auto &keySet : keySets) {
+        // "n != 1" is a function by a lookup table, and "n / 10 % 10 == 1" is interpreted.
+        for (const string pluralExpression : { "n != 1", "n / 10 % 10 == 1" }) {
+            const Catalog catalog = gen_lookup_catalog(keySet.keys, pluralExpression);
+            if (keySet.name == "same-bucket") {
+                const auto &index = catalog.GetIndex();
+                REQUIRE( index.bucket_size(index.bucket(keySet.keys[0])) >= 8 );
+            }
+            const string pluralName = pluralExpression == "n != 1" ? "table" : "interpreted";
+            struct WorkloadT {
+                const char *name;
+                const vector<string> *keys;
+                double zipf;
+            };
+            const WorkloadT workloads[] = {
+                { "hit-uniform", &keySet.keys, 0.0 },
+                { "hit-zipf", &keySet.keys, 1.0 },
+                { "miss", &keySet.missingKeys, 0.0 },
+            };
+            for (const auto &workload : workloads) {
+                const vector<string> &keys = *workload.keys;
+                for (const unsigned int nThreads : threadCounts) {
+                    vector<vector<size_t>> sequences;
+                    for (unsigned int t = 0; t < nThreads; ++t) {
+                        sequences.push_back(gen_lookup_sequence(keys.size(), lookupsPerThread, workload.zipf, t + 1));
+                    }
+                    const pair<const char *, function<size_t(size_t)>> functions[] = {
+                        { "gettext", [&](size_t i) { return catalog.gettext(keys[i]).size(); } },
+                        { "ngettext", [&](size_t i) { return catalog.ngettext(keys[i], plural, i).size(); } },
+                        { "pgettext", [&](size_t i) { return catalog.pgettext(context, keys[i]).size(); } },
+                        { "npgettext", [&](size_t i) { return catalog.npgettext(context, keys[i], plural, i).size(); } },
+                    };
+                    for (const auto &f : functions) {
+                        const double seconds = run_lookup_threads(sequences, f.second);
+                        const size_t lookups = lookupsPerThread * nThreads;
+                        cout << "lookup," << f.first << ',' << keySet.name << ',' << workload.name << ',' << pluralName << ','
+                             << nThreads << ',' << lookups << ',' << setprecision(6) << seconds << ','
+                             << fixed << setprecision(0) << lookups / seconds << defaultfloat << endl;
+                    }
+                }
+            }
+        }
+    }
+
+    // The statistics of a single thread by Catch2.
+    const Catalog catalog = gen_lookup_catalog(keySets[0].keys, "n != 1");
+    const vector<size_t> sequence = gen_lookup_sequence(nKeys, 10000, 1.0, 1);
+    const vector<string> &keys = keySets[0].keys;
+    BENCHMARK( "gettext" ) {
+        size_t sum = 0;
+        for (const size_t i : sequence) {
+            sum += catalog.gettext(keys[i]).size();
+        }
+        return sum;
+    };
+    BENCHMARK( "ngettext" ) {
+        size_t sum = 0;
+        for (const size_t i : sequence) {
+            sum += catalog.ngettext(keys[i], plural, i).size();
+        }
+        return sum;
+    };
+    BENCHMARK( "pgettext" ) {
+        size_t sum = 0;
+        for (const size_t i : sequence) {
+            sum += catalog.pgettext(context, keys[i]).size();
+        }
+        return sum;
+    };
+    BENCHMARK( "npgettext" ) {
+        size_t sum = 0;
+        for (const size_t i : sequence) {
+            sum += catalog.npgettext(context, keys[i], plural, i).size();
+        }
+        return sum;
+    };
+}
+
+namespace {
+    // Report the allocations in func. It prints a CSV line.
+    template <typename F>
+    void report_allocations(const string &operation, const LoadCorpusT &corpus, size_t count, F func)
+    {
+        const alloc_counter::ScopeT scope;
+        const size_t result = func();
+        const alloc_counter::CountsT counts = scope.Get();
+        volatile size_t dummy = result;
+        (void)dummy;
+        cout << "memory," << operation << ',' << corpus.name << ',' << count << ','
+             << counts.allocations << ',' << counts.bytes << ',' << counts.peakBytes << ','
+             << alloc_counter::GetPeakRss() << endl;
+    }
+}
+
+TEST_CASE( "Catalog Memory Benchmark", "[!benchmark]" ) {
+    // Machine readable output: a CSV line per operation.
+    // count is the number of the entries for the loading, or the number of the lookups.
+    cout << "memory,operation,corpus,count,allocations,bytes,peak_bytes,peak_rss" << endl;
+    for (const auto &corpus : gen_load_corpora()) {
+        const string &text = corpus.text;
+        report_allocations("Add(is)", corpus, corpus.entries, [&text]() {
+            MemoryBuffer buf(text.data(), text.data() + text.size());
+            istream is(&buf);
+            Catalog catalog;
+            catalog.Add(is);
+            return catalog.GetIndex().size();
+        });
+        report_allocations("Add(const char *)", corpus, corpus.entries, [&text]() {
+            Catalog catalog;
+            catalog.Add(text.data(), text.data() + text.size());
+            return catalog.GetIndex().size();
+        });
+        const Catalog source(text.begin(), text.end());
+        report_allocations("Merge()", corpus, corpus.entries, [&source]() {
+            Catalog catalog;
+            catalog.Merge(source);
+            return catalog.GetIndex().size();
+        });
+        report_allocations("Copy constructor", corpus, corpus.entries, [&source]() {
+            const Catalog catalog(source);
+            return catalog.GetIndex().size();
+        });
+
+        // The keys to look up.
+        vector<string> ids;
+        vector<pair<string, string>> contextIds;
+        for (const auto &it : source.GetIndex()) {
+            const size_t separator = it.first.find(CONTEXT_SEPARATOR);
+            if (separator == string::npos) {
+                ids.push_back(it.first);
+            } else {
+                contextIds.emplace_back(it.first.substr(0, separator), it.first.substr(separator + 1));
+            }
+        }
+        const string plural("plural");
+        report_allocations("gettext()", corpus, ids.size(), [&]() {
+            size_t sum = 0;
+            for (const auto &id : ids) {
+                sum += source.gettext(id).size();
+            }
+            return sum;
+        });
+        report_allocations("ngettext()", corpus, ids.size(), [&]() {
+            size_t sum = 0;
+            unsigned long n = 0;
+            for (const auto &id : ids) {
+                sum += source.ngettext(id, plural, n++).size();
+            }
+            return sum;
+        });
+        report_allocations("pgettext()", corpus, contextIds.size(), [&]() {
+            size_t sum = 0;
+            for (const auto &id : contextIds) {
+                sum += source.pgettext(id.first, id.second).size();
+            }
+            return sum;
+        });
+        report_allocations("npgettext()", corpus, contextIds.size(), [&]() {
+            size_t sum = 0;
+            unsigned long n = 0;
+            for (const auto &id : contextIds) {
+                sum += source.npgettext(id.first, id.second, plural, n++).size();
+            }
+            return sum;
+        });
+    }
+}
+#endif // ENABLE_BENCHMARK
@@ -0,0 +1,195 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spiritless_po.h"
+#include "AllocationCounter.h"
+
+using namespace std;
+using namespace spiritless_po;
+
+namespace {
+    const string lazy_test_data = R"(# comment
+msgid ""
+msgstr ""
+"Project-Id-Version: lazy-test\n"
+"Plural-Forms: nplurals=3; plural=n%3;\n"
+
+msgid "apple"
+msgstr "APPLE"
+
+msgid "banana"
+msgstr ""
+"BA"
+"NANA"
+
+#, fuzzy
+msgid "cherry"
+msgstr "CHERRY"
+
+msgid "date"
+msgstr ""
+
+msgid "egg"
+msgid_plural "eggs"
+msgstr[0] "EGG#0"
+msgstr[1] "EGG#1"
+msgstr[2] "EGG#2"
+
+msgctxt "food"
+msgid "fig"
+msgstr "FIG\t\"\\\x41\101"
+
+msgid "grape"
+msgstr[1] "error"
+
+msgid "apple"
+msgstr "DISCARDED"
+
+msgctxt "food"
+msgid "honeydew"
+msgid_plural "honeydews"
+msgstr[0] "HONEYDEW#0"
+msgstr[1] "HONEYDEW#1"
+)";
+
+    // Check that the lazy catalog is the same as Catalog.
+    void check_same_as_catalog(const LazyCatalog &lazy, const Catalog &expected)
+    {
+        REQUIRE( lazy.GetMetadata() == expected.GetMetadata() );
+        REQUIRE( lazy.GetError() == expected.GetError() );
+        const auto &a = lazy.GetStatistics();
+        const auto &b = expected.GetStatistics();
+        REQUIRE( a.totalCount == b.totalCount );
+        REQUIRE( a.metadataCount == b.metadataCount );
+        REQUIRE( a.translatedCount == b.translatedCount );
+        REQUIRE( a.discardedCount == b.discardedCount );
+        for (const auto &it : expected.GetIndex()) {
+            REQUIRE( lazy.gettext(it.first) == expected.gettext(it.first) );
+            for (unsigned long n = 0; n < 5; ++n) {
+                REQUIRE( lazy.ngettext(it.first, "plural", n) == expected.ngettext(it.first, "plural", n) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "LazyCatalog::Add()", "[LazyCatalog]" ) {
+    LazyCatalog catalog;
+    REQUIRE( !catalog.Add(lazy_test_data) );
+    const Catalog expected(lazy_test_data.begin(), lazy_test_data.end());
+    check_same_as_catalog(catalog, expected);
+
+    REQUIRE( catalog.gettext("apple") == "APPLE" );
+    REQUIRE( catalog.gettext("banana") == "BANANA" );
+    REQUIRE( catalog.gettext("cherry") == "cherry" );
+    REQUIRE( catalog.gettext("date") == "date" );
+    REQUIRE( catalog.ngettext("egg", "eggs", 1) == "EGG#1" );
+    REQUIRE( catalog.ngettext("egg", "eggs", 5) == "EGG#2" );
+    REQUIRE( catalog.pgettext("food", "fig") == "FIG\t\"\\AA" );
+    REQUIRE( catalog.npgettext("food", "honeydew", "honeydews", 1) == "HONEYDEW#1" );
+    REQUIRE( catalog.npgettext("food", "honeydew", "honeydews", 2) == "HONEYDEW#0" );
+    REQUIRE( catalog.GetMetadata().at("Project-Id-Version") == "lazy-test" );
+
+    const string singular("kiwi");
+    const string plural("kiwis");
+    REQUIRE( &catalog.gettext(singular) == &singular );
+    REQUIRE( &catalog.ngettext(singular, plural, 1) == &singular );
+    REQUIRE( &catalog.ngettext(singular, plural, 2) == &plural );
+    REQUIRE( &catalog.pgettext("food", singular) == &singular );
+    REQUIRE( &catalog.npgettext("food", singular, plural, 2) == &plural );
+
+    // The decoded text is the same object.
+    REQUIRE( &catalog.gettext("apple") == &catalog.gettext("apple") );
+
+    catalog.ClearError();
+    REQUIRE( catalog.GetError().empty() );
+    catalog.ClearStatistics();
+    REQUIRE( catalog.GetStatistics().totalCount == 0 );
+    catalog.Clear();
+    REQUIRE( catalog.gettext("apple") == "apple" );
+    REQUIRE( catalog.GetMetadata().empty() );
+}
+
+TEST_CASE( "LazyCatalog::Add() for some texts", "[LazyCatalog]" ) {
+    const string text2 = "msgid \"\"\nmsgstr \"Language: xx\\n\"\n\nmsgid \"apple\"\nmsgstr \"APPLE2\"\n\nmsgid \"lemon\"\nmsgstr \"LEMON\"\n";
+    LazyCatalog catalog;
+    catalog.Add(lazy_test_data);
+    catalog.Add(text2);
+    Catalog expected(lazy_test_data.begin(), lazy_test_data.end());
+    expected.Add(text2.begin(), text2.end());
+    check_same_as_catalog(catalog, expected);
+
+    // The moved catalog keeps the source texts.
+    LazyCatalog moved(std::move(catalog));
+    check_same_as_catalog(moved, expected);
+}
+
+TEST_CASE( "LazyCatalog::AddFile()", "[LazyCatalog]" ) {
+    const string path = "test_spiritless_po_lazy.po";
+    {
+        ofstream f(path, ios::binary);
+        f << lazy_test_data;
+    }
+    LazyCatalog catalog;
+    REQUIRE( !catalog.AddFile(path.c_str()) );
+    remove(path.c_str());
+    const Catalog expected(lazy_test_data.begin(), lazy_test_data.end());
+    check_same_as_catalog(catalog, expected);
+
+    REQUIRE( !catalog.AddFile("not_existed.po") );
+    REQUIRE( catalog.GetError().back() == "Can't open the file." );
+}
+
+TEST_CASE( "LazyCatalog decodes msgstr on some threads", "[LazyCatalog]" ) {
+    string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += "msgid \"key" + to_string(i) + "\"\nmsgstr \"value" + to_string(i) + "\"\n\n";
+    }
+    LazyCatalog catalog;
+    REQUIRE( catalog.Add(text) );
+    vector<thread> threads;
+    vector<int> results(4, 0);
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&catalog, &results, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                if (catalog.gettext("key" + to_string(i)) == "value" + to_string(i)) {
+                    ++results[t];
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (const int n : results) {
+        REQUIRE( n == 1000 );
+    }
+}
+
+TEST_CASE( "LazyCatalog lookup doesn't allocate memory after the first use", "[LazyCatalog]" ) {
+    LazyCatalog catalog;
+    catalog.Add(lazy_test_data);
+    const string apple("apple");
+    const string egg("egg");
+    const string eggs("eggs");
+    REQUIRE( catalog.gettext(apple) == "APPLE" );
+    REQUIRE( catalog.ngettext(egg, eggs, 2) == "EGG#2" );
+
+    size_t sum = 0;
+    const alloc_counter::ScopeT scope;
+    for (unsigned long n = 0; n < 10; ++n) {
+        sum += catalog.gettext(apple).size();
+        sum += catalog.ngettext(egg, eggs, n).size();
+    }
+    const alloc_counter::CountsT counts = scope.Get();
+    CHECK( sum > 0 );
+    CHECK( counts.allocations == 0 );
+}
@@ -0,0 +1,178 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// This file is built into test_load_profile with SPIRITLESS_PO_DEBUG_LOAD_PROFILE, because the macro changes the members of Catalog.
+#ifndef SPIRITLESS_PO_DEBUG_LOAD_PROFILE
+#error SPIRITLESS_PO_DEBUG_LOAD_PROFILE must be defined for all the files of test_load_profile.
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spiritless_po.h"
+#include "PoCorpusGenerator.h"
+
+using namespace std;
+using namespace spiritless_po;
+
+namespace {
+    const string poText(
+        "msgid \"\"\n"
+        "msgstr \"\"\n"
+        "\"Plural-Forms: nplurals=2; plural=n != 1;\\n\"\n"
+        "\n"
+        "msgid \"apple\"\n"
+        "msgstr \"APPLE\"\n"
+        "\n"
+        "msgctxt \"menu\"\n"
+        "msgid \"open\"\n"
+        "msgstr \"OPEN\"\n"
+        "\n"
+        "msgid \"file\"\n"
+        "msgid_plural \"files\"\n"
+        "msgstr[0] \"FILE\"\n"
+        "msgstr[1] \"FILES\"\n"
+        "\n"
+        "msgid \"apple\"\n"
+        "msgstr \"APPLE2\"\n");
+
+    // The counts that are independent of the way to add.
+    void check_counts(const Catalog::LoadProfileT &profile)
+    {
+        CHECK(profile.total.count == 1);
+        CHECK(profile.lex.bytes == poText.size());
+        CHECK(profile.parseText.count == 14);
+        CHECK(profile.parseText.bytes == 92);
+        CHECK(profile.assemble.count == 5);
+        CHECK(profile.hash.count == 5);
+        CHECK(profile.hash.bytes == 23);
+        CHECK(profile.index.count == 5);
+        CHECK(profile.metadata.count == 1);
+        CHECK(profile.metadata.bytes == 41);
+    }
+
+    // The sum of the phases except for hash doesn't exceed total.
+    void check_times(const Catalog::LoadProfileT &profile)
+    {
+        const Catalog::LoadProfileT::PhaseT *const phases[] = {
+            &profile.read, &profile.decompress, &profile.lex, &profile.parseText,
+            &profile.assemble, &profile.index, &profile.metadata,
+        };
+        std::uint64_t sum = 0;
+        for (const auto *phase : phases) {
+            sum += phase->nanoseconds;
+        }
+        CHECK(profile.total.nanoseconds > 0);
+        CHECK(sum <= profile.total.nanoseconds);
+    }
+}
+
+TEST_CASE( "Catalog::GetLoadProfile() by Add(begin, end)", "[LoadProfile]" ) {
+    Catalog catalog;
+    catalog.Add(poText.begin(), poText.end());
+    const Catalog::LoadProfileT &profile = catalog.GetLoadProfile();
+    check_counts(profile);
+    check_times(profile);
+    CHECK(profile.lex.count == 28);
+    CHECK(profile.read.count == 0);
+    CHECK(profile.decompress.count == 0);
+    CHECK(catalog.GetStatistics().discardedCount == 1);
+
+    // The profile is accumulated.
+    catalog.Add(poText.data(), poText.data() + poText.size());
+    CHECK(catalog.GetLoadProfile().total.count == 2);
+    CHECK(catalog.GetLoadProfile().lex.bytes == poText.size() * 2);
+    CHECK(catalog.GetLoadProfile().metadata.count == 1);
+
+    catalog.ClearLoadProfile();
+    CHECK(catalog.GetLoadProfile().total.count == 0);
+    CHECK(catalog.GetLoadProfile().total.nanoseconds == 0);
+    CHECK(catalog.GetLoadProfile().lex.bytes == 0);
+}
+
+TEST_CASE( "Catalog::GetLoadProfile() by Add(is)", "[LoadProfile]" ) {
+    istringstream is(poText);
+    Catalog catalog;
+    catalog.Add(is);
+    const Catalog::LoadProfileT &profile = catalog.GetLoadProfile();
+    // IncrementalAdder in Add(is) doesn't count the call again.
+    check_counts(profile);
+    check_times(profile);
+    CHECK(profile.read.bytes == poText.size());
+    CHECK(profile.read.count == 2);
+    // The token at the end of a block is lexed again with the next block.
+    CHECK(profile.lex.count >= 28);
+    // The plain text is passed through Decompressor.
+    CHECK(profile.decompress.bytes == poText.size());
+}
+
+TEST_CASE( "Catalog::GetLoadProfile() by IncrementalAdder", "[LoadProfile]" ) {
+    Catalog catalog;
+    {
+        Catalog::IncrementalAdder adder(catalog);
+        for (size_t i = 0; i < poText.size(); i += 7) {
+            adder.Feed(poText.data() + i, min<size_t>(7, poText.size() - i));
+        }
+        adder.Finish();
+    }
+    const Catalog::LoadProfileT &profile = catalog.GetLoadProfile();
+    CHECK(profile.total.count == (poText.size() + 6) / 7 + 1);
+    CHECK(profile.lex.bytes == poText.size());
+    CHECK(profile.assemble.count == 5);
+    CHECK(profile.index.count == 5);
+    CHECK(profile.metadata.count == 1);
+    CHECK(catalog.GetIndex().size() == 4);
+}
+
+TEST_CASE( "Catalog::GetLoadProfile() isn't changed by the other catalogs", "[LoadProfile]" ) {
+    Catalog a;
+    Catalog b;
+    a.Add(poText.begin(), poText.end());
+    b.Add(poText.begin(), poText.end());
+    check_counts(a.GetLoadProfile());
+    check_counts(b.GetLoadProfile());
+
+    // A copy has the profile of the source.
+    Catalog c(a);
+    CHECK(c.GetLoadProfile().total.count == 1);
+    c.Clear();
+    CHECK(c.GetLoadProfile().total.count == 0);
+}
+
+TEST_CASE( "Catalog::GetLoadProfile() of a corpus", "[LoadProfile]" ) {
+    po_corpus::OptionsT options;
+    options.entries = 1000;
+    options.escapeRatio = 0.3;
+    options.contextRatio = 0.5;
+    options.pluralRatio = 0.5;
+    const string text = po_corpus::PoCorpusGenerator(options).Generate();
+    Catalog catalog;
+    catalog.Add(text.begin(), text.end());
+    const Catalog::LoadProfileT &profile = catalog.GetLoadProfile();
+    CHECK(catalog.GetError().empty());
+    CHECK(profile.lex.bytes == text.size());
+    CHECK(profile.assemble.count == catalog.GetStatistics().totalCount);
+    CHECK(profile.index.count == catalog.GetIndex().size());
+    check_times(profile);
+
+    // The breakdown is printed to see the proportions.
+    const pair<const char *, const Catalog::LoadProfileT::PhaseT *> phases[] = {
+        { "total", &profile.total }, { "read", &profile.read }, { "decompress", &profile.decompress },
+        { "lex", &profile.lex }, { "parseText", &profile.parseText }, { "assemble", &profile.assemble },
+        { "hash", &profile.hash }, { "index", &profile.index }, { "metadata", &profile.metadata },
+    };
+    printf("load_profile,phase,nanoseconds,bytes,count,percent\n");
+    for (const auto &it : phases) {
+        printf("load_profile,%s,%llu,%llu,%llu,%.1f\n", it.first,
+            static_cast<unsigned long long>(it.second->nanoseconds),
+            static_cast<unsigned long long>(it.second->bytes),
+            static_cast<unsigned long long>(it.second->count),
+            100.0 * static_cast<double>(it.second->nanoseconds) / static_cast<double>(profile.total.nanoseconds));
+    }
+}
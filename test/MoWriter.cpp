@@ -0,0 +1,380 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "spiritless_po.h"
+#include "MoWriter.h"
+
+#if defined(ENABLE_BENCHMARK) && defined(__GLIBC__)
+#include <chrono>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <libintl.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PoCorpusGenerator.h"
+#endif
+
+using namespace std;
+using namespace spiritless_po;
+
+namespace {
+    // A minimal reader of the MO data that is written by mo_writer.
+    class MoReader {
+    public:
+        explicit MoReader(const string &mo)
+            : mo(mo)
+        {
+        }
+
+        uint32_t Word(size_t offset) const
+        {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(mo.data() + offset);
+            return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        uint32_t Count() const
+        {
+            return Word(8);
+        }
+
+        string Original(uint32_t i) const
+        {
+            return String(Word(12) + i * 8);
+        }
+
+        string Translated(uint32_t i) const
+        {
+            return String(Word(16) + i * 8);
+        }
+
+        // Find the index of the original string by the hash table as GNU gettext does.
+        // Return Count() if it's not found.
+        uint32_t Find(const string &key) const
+        {
+            const uint32_t hashSize = Word(20);
+            const uint32_t hashOffset = Word(24);
+            const uint32_t hval = mo_writer::HashString(key.c_str());
+            uint32_t idx = hval % hashSize;
+            const uint32_t incr = 1 + hval % (hashSize - 2);
+            for (;;) {
+                const uint32_t n = Word(hashOffset + idx * 4);
+                if (n == 0) {
+                    return Count();
+                }
+                const string original = Original(n - 1);
+                if (original.compare(0, original.find('\0'), key) == 0) {
+                    return n - 1;
+                }
+                idx = idx >= hashSize - incr ? idx - (hashSize - incr) : idx + incr;
+            }
+        }
+
+    private:
+        string String(size_t descriptor) const
+        {
+            return mo.substr(Word(descriptor + 4), Word(descriptor));
+        }
+
+        const string &mo;
+    };
+}
+
+TEST_CASE( "mo_writer::MakeMo()", "[MoWriter]" ) {
+    const string text = R"(msgid ""
+msgstr ""
+"Content-Type: text/plain; charset=UTF-8\n"
+"Plural-Forms: nplurals=2; plural=n != 1;\n"
+
+msgid "apple"
+msgstr "APPLE"
+
+msgid "egg"
+msgid_plural "eggs"
+msgstr[0] "EGG"
+msgstr[1] "EGGS"
+
+msgctxt "food"
+msgid "fig"
+msgstr "FIG"
+
+msgid "banana"
+msgstr "BANANA"
+)";
+    const Catalog catalog(text.begin(), text.end());
+    REQUIRE( catalog.GetError().empty() );
+    const string mo = mo_writer::MakeMo(catalog);
+    const MoReader reader(mo);
+
+    REQUIRE( reader.Word(0) == 0x950412DE );
+    REQUIRE( reader.Word(4) == 0 );
+    REQUIRE( reader.Count() == 5 );
+    REQUIRE( reader.Word(20) == 7 );
+
+    // The original strings are sorted, and the metadata is the first.
+    REQUIRE( reader.Original(0) == "" );
+    for (uint32_t i = 1; i < reader.Count(); ++i) {
+        REQUIRE( reader.Original(i - 1) < reader.Original(i) );
+    }
+    REQUIRE( reader.Translated(0) == catalog.gettext("") );
+
+    REQUIRE( reader.Translated(reader.Find("apple")) == "APPLE" );
+    REQUIRE( reader.Translated(reader.Find("banana")) == "BANANA" );
+    const uint32_t egg = reader.Find("egg");
+    REQUIRE( reader.Original(egg) == string("egg\0egg", 7) );
+    REQUIRE( reader.Translated(egg) == string("EGG\0EGGS", 8) );
+    REQUIRE( reader.Translated(reader.Find(string("food") + CONTEXT_SEPARATOR + "fig")) == "FIG" );
+    REQUIRE( reader.Find("cherry") == reader.Count() );
+}
+
+TEST_CASE( "mo_writer::HashString() and GetHashSize()", "[MoWriter]" ) {
+    REQUIRE( mo_writer::HashString("") == 0 );
+    REQUIRE( mo_writer::HashString("a") == 0x61 );
+    REQUIRE( mo_writer::HashString("ab") == 0x672 );
+    // The high nibble is folded.
+    REQUIRE( mo_writer::HashString("abcdefghij") == 0xABAA66A );
+    REQUIRE( mo_writer::GetHashSize(0) == 3 );
+    REQUIRE( mo_writer::GetHashSize(5) == 7 );
+    REQUIRE( mo_writer::GetHashSize(1000) == 1361 );
+}
+
+
+// For some reason, "g++ -D_GLIBCXX_DEBUG" causes some errors in BENCHMARK()...
+#if defined(ENABLE_BENCHMARK) && defined(__GLIBC__)
+namespace {
+    // The size of the heap in use, including the allocations by malloc() in GNU gettext.
+    size_t heap_in_use()
+    {
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+        return mallinfo2().uordblks;
+#else
+        return static_cast<size_t>(mallinfo().uordblks);
+#endif
+    }
+
+    // The locale directory for bindtextdomain(), and the MO files in it.
+    class LocaleDirectory {
+    public:
+        LocaleDirectory(const string &locale, const string &mo, int domains)
+        {
+            char cwd[4096];
+            root = string(getcwd(cwd, sizeof(cwd)) != nullptr ? cwd : ".") + "/test_spiritless_po_locale";
+            dirs.push_back(root);
+            dirs.push_back(root + "/" + locale);
+            dirs.push_back(root + "/" + locale + "/LC_MESSAGES");
+            for (const auto &dir : dirs) {
+                mkdir(dir.c_str(), 0755);
+            }
+            for (int i = 0; i < domains; ++i) {
+                const string path = dirs.back() + "/" + Domain(i) + ".mo";
+                ofstream f(path, ios::binary);
+                f << mo;
+                files.push_back(path);
+            }
+        }
+
+        ~LocaleDirectory()
+        {
+            for (const auto &path : files) {
+                remove(path.c_str());
+            }
+            for (auto it = dirs.rbegin(); it != dirs.rend(); ++it) {
+                rmdir(it->c_str());
+            }
+        }
+
+        // A domain is loaded only once, so the load time is measured on some domains of the same MO file.
+        static string Domain(int i)
+        {
+            return "spiritless_po_bench_" + to_string(i);
+        }
+
+        string root;
+        vector<string> dirs;
+        vector<string> files;
+    };
+
+    double seconds_since(const chrono::steady_clock::time_point &start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Print a CSV line.
+    void report_compare(const char *operation, const char *implementation, size_t count, double seconds, size_t heapBytes, size_t fileBytes)
+    {
+        cout << "compare," << operation << ',' << implementation << ',' << count << ','
+             << setprecision(6) << seconds << ',' << fixed << setprecision(1) << seconds / count * 1e9 << defaultfloat << ','
+             << heapBytes << ',' << fileBytes << endl;
+    }
+
+    // Get the best time of the lookups.
+    template <typename F>
+    double best_lookup_time(const vector<size_t> &sequence, F lookup)
+    {
+        double best = numeric_limits<double>::max();
+        for (int run = 0; run < 5; ++run) {
+            size_t sum = 0;
+            const auto start = chrono::steady_clock::now();
+            for (const size_t i : sequence) {
+                sum += lookup(i);
+            }
+            best = min(best, seconds_since(start));
+            volatile size_t dummy = sum;
+            (void)dummy;
+        }
+        return best;
+    }
+}
+
+TEST_CASE( "Catalog vs GNU gettext Benchmark", "[!benchmark]" ) {
+    po_corpus::OptionsT options;
+    options.entries = 50000;
+    options.errorRatio = 0.0;
+    const string text = po_corpus::PoCorpusGenerator(options).Generate();
+    const Catalog source(text.begin(), text.end());
+    const string mo = mo_writer::MakeMo(source);
+
+    // The msgid without msgctxt, the same number of the missing keys, and a translated key to check the locale.
+    vector<string> keys;
+    vector<string> missingKeys;
+    for (const auto &it : source.GetIndex()) {
+        if (!it.first.empty() && it.first.find(CONTEXT_SEPARATOR) == string::npos) {
+            keys.push_back(it.first);
+            missingKeys.push_back("missing " + it.first);
+        }
+    }
+    REQUIRE( !keys.empty() );
+    const string &probe = keys.front();
+
+    // GNU gettext doesn't look up the messages in the C locale, so find a usable locale.
+    const int domains = 6;
+    const string oldLocale = setlocale(LC_MESSAGES, nullptr);
+    const char *const language = getenv("LANGUAGE");
+    const bool hasLanguage = language != nullptr;
+    const string oldLanguage = hasLanguage ? language : "";
+    unsetenv("LANGUAGE");
+    unique_ptr<LocaleDirectory> dir;
+    string locale;
+    for (const char *candidate : { "C.UTF-8", "C.utf8", "en_US.UTF-8", "en_US.utf8" }) {
+        const char *const name = setlocale(LC_MESSAGES, candidate);
+        if (name == nullptr) {
+            continue;
+        }
+        dir.reset(new LocaleDirectory(name, mo, domains));
+        for (int i = 0; i < domains; ++i) {
+            bindtextdomain(LocaleDirectory::Domain(i).c_str(), dir->root.c_str());
+            bind_textdomain_codeset(LocaleDirectory::Domain(i).c_str(), "UTF-8");
+        }
+        if (source.gettext(probe) == dgettext(LocaleDirectory::Domain(0).c_str(), probe.c_str())) {
+            locale = name;
+            break;
+        }
+        dir.reset();
+    }
+    if (locale.empty()) {
+        setlocale(LC_MESSAGES, oldLocale.c_str());
+        if (hasLanguage) {
+            setenv("LANGUAGE", oldLanguage.c_str(), 1);
+        }
+        SKIP( "No locale is usable for GNU gettext." );
+    }
+    const string domain = LocaleDirectory::Domain(0);
+
+    // The translations must be the same.
+    size_t mismatches = 0;
+    for (const auto &key : keys) {
+        if (source.gettext(key) != dgettext(domain.c_str(), key.c_str())) {
+            ++mismatches;
+        }
+        for (unsigned long n = 0; n < 3; ++n) {
+            if (source.ngettext(key, key, n) != dngettext(domain.c_str(), key.c_str(), key.c_str(), n)) {
+                ++mismatches;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+
+    // Machine readable output: a CSV line per measurement.
+    // heap_bytes is the increase of the heap by the loading, and file_bytes is the size of the file that is loaded.
+    cout << "compare,operation,implementation,count,seconds,ns_per_op,heap_bytes,file_bytes" << endl;
+    cout << "# locale: " << locale << endl;
+
+    // Loading.
+    const string poPath = dir->root + "/bench.po";
+    {
+        ofstream f(poPath, ios::binary);
+        f << text;
+    }
+    double best = numeric_limits<double>::max();
+    size_t heapBytes = 0;
+    for (int run = 0; run < domains - 1; ++run) {
+        const size_t heapBefore = heap_in_use();
+        const auto start = chrono::steady_clock::now();
+        Catalog catalog;
+        catalog.AddFile(poPath.c_str());
+        best = min(best, seconds_since(start));
+        heapBytes = heap_in_use() - heapBefore;
+    }
+    remove(poPath.c_str());
+    report_compare("load", "spiritless_po", source.GetIndex().size(), best, heapBytes, text.size());
+    best = numeric_limits<double>::max();
+    for (int i = 1; i < domains; ++i) {
+        // The first lookup in a domain loads the MO file.
+        const string d = LocaleDirectory::Domain(i);
+        const size_t heapBefore = heap_in_use();
+        const auto start = chrono::steady_clock::now();
+        const char *const s = dgettext(d.c_str(), probe.c_str());
+        best = min(best, seconds_since(start));
+        heapBytes = heap_in_use() - heapBefore;
+        CHECK( s != probe.c_str() );
+    }
+    report_compare("load", "glibc", source.GetIndex().size(), best, heapBytes, mo.size());
+
+    // Lookups.
+    const size_t lookups = 200000;
+    vector<size_t> sequence(lookups);
+    mt19937_64 engine(1);
+    for (auto &i : sequence) {
+        i = static_cast<size_t>(engine() % keys.size());
+    }
+    report_compare("gettext-hit", "spiritless_po", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return source.gettext(keys[i]).size();
+    }), 0, 0);
+    report_compare("gettext-hit", "glibc", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return static_cast<size_t>(dgettext(domain.c_str(), keys[i].c_str())[0]);
+    }), 0, 0);
+    report_compare("gettext-miss", "spiritless_po", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return source.gettext(missingKeys[i]).size();
+    }), 0, 0);
+    report_compare("gettext-miss", "glibc", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return static_cast<size_t>(dgettext(domain.c_str(), missingKeys[i].c_str())[0]);
+    }), 0, 0);
+    report_compare("ngettext-hit", "spiritless_po", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return source.ngettext(keys[i], keys[i], i).size();
+    }), 0, 0);
+    report_compare("ngettext-hit", "glibc", lookups, best_lookup_time(sequence, [&](size_t i) {
+        return static_cast<size_t>(dngettext(domain.c_str(), keys[i].c_str(), keys[i].c_str(), i)[0]);
+    }), 0, 0);
+
+    dir.reset();
+    setlocale(LC_MESSAGES, oldLocale.c_str());
+    if (hasLanguage) {
+        setenv("LANGUAGE", oldLanguage.c_str(), 1);
+    }
+}
+#endif // ENABLE_BENCHMARK && __GLIBC__
@@ -0,0 +1,163 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// The writer of the GNU MO file for the comparison with GNU gettext.
+// It writes the sorted string tables and the hash table in the same layout as msgfmt, so the lookup of GNU gettext is as fast as with the files made by msgfmt.
+
+#ifndef SPIRITLESS_PO_TEST_MO_WRITER_H_
+#define SPIRITLESS_PO_TEST_MO_WRITER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spiritless_po.h"
+
+namespace mo_writer {
+    // An entry: the original string and the translated string.
+    // The original string of a plural entry is msgid + '\0' + msgid_plural, and the translated string is msgstr[0] + '\0' + msgstr[1] + ...
+    typedef std::pair<std::string, std::string> EntryT;
+
+    // The hash function of GNU gettext. The string ends at the first '\0'.
+    std::uint32_t HashString(const char *s) noexcept;
+
+    // Get the size of the hash table for n entries, as msgfmt does.
+    std::uint32_t GetHashSize(std::size_t n) noexcept;
+
+    // Make the MO data of the entries, in the little endian.
+    std::string MakeMo(std::vector<EntryT> entries);
+
+    // Make the MO data of the entries in a catalog.
+    // msgid_plural is the same as msgid, because Catalog doesn't keep msgid_plural.
+    std::string MakeMo(const spiritless_po::Catalog &catalog);
+
+    inline std::uint32_t HashString(const char *s) noexcept
+    {
+        std::uint32_t hval = 0;
+        while (*s != '\0') {
+            hval <<= 4;
+            hval += static_cast<unsigned char>(*s++);
+            const std::uint32_t g = hval & (static_cast<std::uint32_t>(0xF) << 28);
+            if (g != 0) {
+                hval ^= g >> 24;
+                hval ^= g;
+            }
+        }
+        return hval;
+    }
+
+    inline std::uint32_t GetHashSize(const std::size_t n) noexcept
+    {
+        // The smallest odd prime that is not less than n * 4 / 3, and not less than 3.
+        std::uint32_t size = static_cast<std::uint32_t>(n * 4 / 3);
+        if (size < 3) {
+            size = 3;
+        }
+        size |= 1;
+        for (;; size += 2) {
+            bool isPrime = true;
+            for (std::uint32_t d = 3; d * d <= size; d += 2) {
+                if (size % d == 0) {
+                    isPrime = false;
+                    break;
+                }
+            }
+            if (isPrime) {
+                return size;
+            }
+        }
+    }
+
+    inline std::string MakeMo(std::vector<EntryT> entries)
+    {
+        // GNU gettext uses the binary search if the hash table isn't found, so the entries are sorted.
+        std::sort(entries.begin(), entries.end(), [](const EntryT &a, const EntryT &b) {
+            return a.first < b.first;
+        });
+        const std::uint32_t n = static_cast<std::uint32_t>(entries.size());
+        const std::uint32_t hashSize = GetHashSize(n);
+        const std::uint32_t headerSize = 28;
+        const std::uint32_t originalOffset = headerSize;
+        const std::uint32_t translatedOffset = originalOffset + n * 8;
+        const std::uint32_t hashOffset = translatedOffset + n * 8;
+        const std::uint32_t stringOffset = hashOffset + hashSize * 4;
+
+        std::vector<std::uint32_t> words;
+        words.push_back(0x950412DE); // Magic number.
+        words.push_back(0); // Revision.
+        words.push_back(n);
+        words.push_back(originalOffset);
+        words.push_back(translatedOffset);
+        words.push_back(hashSize);
+        words.push_back(hashOffset);
+        std::string strings;
+        for (const auto &entry : entries) {
+            words.push_back(static_cast<std::uint32_t>(entry.first.size()));
+            words.push_back(stringOffset + static_cast<std::uint32_t>(strings.size()));
+            strings += entry.first;
+            strings += '\0';
+        }
+        for (const auto &entry : entries) {
+            words.push_back(static_cast<std::uint32_t>(entry.second.size()));
+            words.push_back(stringOffset + static_cast<std::uint32_t>(strings.size()));
+            strings += entry.second;
+            strings += '\0';
+        }
+
+        // The open addressing hash table of (the index + 1), or 0 for an empty slot.
+        std::vector<std::uint32_t> hashTable(hashSize, 0);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            const std::uint32_t hval = HashString(entries[i].first.c_str());
+            std::uint32_t idx = hval % hashSize;
+            const std::uint32_t incr = 1 + hval % (hashSize - 2);
+            while (hashTable[idx] != 0) {
+                idx = idx >= hashSize - incr ? idx - (hashSize - incr) : idx + incr;
+            }
+            hashTable[idx] = i + 1;
+        }
+        words.insert(words.end(), hashTable.begin(), hashTable.end());
+
+        std::string mo;
+        mo.reserve(words.size() * 4 + strings.size());
+        for (const std::uint32_t w : words) {
+            mo += static_cast<char>(w & 0xFF);
+            mo += static_cast<char>((w >> 8) & 0xFF);
+            mo += static_cast<char>((w >> 16) & 0xFF);
+            mo += static_cast<char>((w >> 24) & 0xFF);
+        }
+        mo += strings;
+        return mo;
+    }
+
+    inline std::string MakeMo(const spiritless_po::Catalog &catalog)
+    {
+        const std::vector<std::string> &stringTable = catalog.GetStringTable();
+        std::vector<EntryT> entries;
+        entries.reserve(catalog.GetIndex().size());
+        for (const auto &it : catalog.GetIndex()) {
+            const std::string &msgid = it.first;
+            const std::size_t first = it.second.stringTableIndex;
+            const std::size_t count = it.second.totalPlurals;
+            std::string original(msgid);
+            std::string translated(stringTable[first]);
+            if (count > 1) {
+                const std::size_t separator = msgid.find(spiritless_po::CONTEXT_SEPARATOR);
+                original += '\0';
+                original.append(msgid, separator == std::string::npos ? 0 : separator + 1, std::string::npos);
+                for (std::size_t i = 1; i < count; ++i) {
+                    translated += '\0';
+                    translated += stringTable[first + i];
+                }
+            }
+            entries.emplace_back(std::move(original), std::move(translated));
+        }
+        return MakeMo(std::move(entries));
+    }
+} // namespace mo_writer
+
+#endif // SPIRITLESS_PO_TEST_MO_WRITER_H_
@@ -1,5 +1,5 @@
 /*
-  Copyright © 2022, 2024 OOTA, Masato
+  Copyright © 2022, 2024, 2026 OOTA, Masato
             © 2013 Translate.
   License: CC-BY-SA-3.0
   See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
@@ -11,6 +11,7 @@
 #include <catch2/generators/catch_generators_range.hpp>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef NDEBUG
@@ -32,10 +33,41 @@
 #include "spiritless_po/PluralParser.h"
 #undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE
 
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE NO_LOOKUP_TABLE
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_PLURAL_PARSER_H_
+#include "spiritless_po/PluralParser.h"
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE
+
 #define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE INTERPRETER
 #define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
 #undef SPIRITLESS_PO_PLURAL_PARSER_H_
 #include "spiritless_po/PluralParser.h"
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE
+
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE INTERPRETER_SWITCH
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_SWITCH
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_PLURAL_PARSER_H_
+#include "spiritless_po/PluralParser.h"
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_SWITCH
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE
+
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE INTERPRETER_NO_OPTIMIZATION
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_OPTIMIZATION
+#define SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_PLURAL_PARSER_H_
+#include "spiritless_po/PluralParser.h"
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_LOOKUP_TABLE
+#undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NO_OPTIMIZATION
 #undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_USE_INTERPRETER
 #undef SPIRITLESS_PO_DEBUG_PLURAL_PARSER_NAMESPACE
 
@@ -232,14 +264,14 @@ namespace {
 #endif // ENABLE_BENCHMARK
 }
 
-TEMPLATE_TEST_CASE( "Default Constructor of PluralFunction", "[PluralFunction]", PluralParser, ENABLE_ASSERT::PluralParser, INTERPRETER::PluralParser ) {
+TEMPLATE_TEST_CASE( "Default Constructor of PluralFunction", "[PluralFunction]", PluralParser, ENABLE_ASSERT::PluralParser, NO_LOOKUP_TABLE::PluralParser, INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, INTERPRETER_NO_OPTIMIZATION::PluralParser ) {
     PluralParser::FunctionType plural_function;
     REQUIRE( plural_function(0) == 1 );
     REQUIRE( plural_function(1) == 0 );
     REQUIRE( plural_function(99) == 1 );
 }
 
-TEMPLATE_TEST_CASE( "Operators of PluralFunction", "[PluralFunction]", PluralParser, ENABLE_ASSERT::PluralParser, INTERPRETER::PluralParser ) {
+TEMPLATE_TEST_CASE( "Operators of PluralFunction", "[PluralFunction]", PluralParser, ENABLE_ASSERT::PluralParser, NO_LOOKUP_TABLE::PluralParser, INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, INTERPRETER_NO_OPTIMIZATION::PluralParser ) {
     SECTION( "Numeric operators priority and association" ) {
         auto it = PluralParser::Parse("1 + 2 * 3 + (4 + 5) * 6 / 5 % 3 - 7 + 8");
         REQUIRE( it(0) == 1 + 2 * 3 + (4 + 5) * 6 / 5 % 3 - 7 + 8 );
@@ -269,7 +301,7 @@ TEMPLATE_TEST_CASE( "Operators of PluralFunction", "[PluralFunction]", PluralPar
     };
 }
 
-TEMPLATE_TEST_CASE( "Equality in PluralFunction", "[PluralFunction]",  PluralParser, ENABLE_ASSERT::PluralParser, INTERPRETER::PluralParser, DEBUG_32BIT_NUM::PluralParser, DEBUG_32BIT_IF::PluralParser, DEBUG_32BIT_ELSE::PluralParser, DEBUG_32BIT_IF_ELSE::PluralParser, DEBUG_32BIT_ALL::PluralParser ) {
+TEMPLATE_TEST_CASE( "Equality in PluralFunction", "[PluralFunction]",  PluralParser, ENABLE_ASSERT::PluralParser, NO_LOOKUP_TABLE::PluralParser, INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, INTERPRETER_NO_OPTIMIZATION::PluralParser, DEBUG_32BIT_NUM::PluralParser, DEBUG_32BIT_IF::PluralParser, DEBUG_32BIT_ELSE::PluralParser, DEBUG_32BIT_IF_ELSE::PluralParser, DEBUG_32BIT_ALL::PluralParser ) {
     vector<typename TestType::FunctionType> test_funcs;
     for (auto &info : plural_forms) {
         auto it = TestType::Parse(info);
@@ -390,6 +422,171 @@ TEMPLATE_TEST_CASE( "Equality in PluralFunction", "[PluralFunction]",  PluralPar
 }
 
 
+TEMPLATE_TEST_CASE( "Superinstructions of PluralFunction", "[PluralFunction]", ENABLE_ASSERT::PluralParser, INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, INTERPRETER_NO_OPTIMIZATION::PluralParser, DEBUG_32BIT_ALL::PluralParser ) {
+    // "n op k" and "(n + 1) op k" are fused, and "k op n" is fused only for the comparisons.
+    auto f = [](const string &op, const string &left, const string &right) {
+        return TestType::Parse(left + " " + op + " " + right);
+    };
+    const NumT k = 7;
+    const string ks = "7";
+    for (const NumT n : { 0UL, 1UL, 6UL, 7UL, 8UL, 13UL, 14UL, 1000UL }) {
+        INFO( "n = " << n );
+        CHECK( f("*", "n", ks)(n) == n * k );
+        CHECK( f("/", "n", ks)(n) == n / k );
+        CHECK( f("%", "n", ks)(n) == n % k );
+        CHECK( f("+", "n", ks)(n) == n + k );
+        CHECK( f("-", "n", "0")(n) == n );
+        CHECK( f("<=", "n", ks)(n) == (n <= k) );
+        CHECK( f("<", "n", ks)(n) == (n < k) );
+        CHECK( f(">", "n", ks)(n) == (n > k) );
+        CHECK( f(">=", "n", ks)(n) == (n >= k) );
+        CHECK( f("==", "n", ks)(n) == (n == k) );
+        CHECK( f("!=", "n", ks)(n) == (n != k) );
+        CHECK( f("&&", "n", ks)(n) == (n && k) );
+        CHECK( f("||", "n", "0")(n) == (n || 0) );
+
+        CHECK( f("*", "(n + 1)", ks)(n) == (n + 1) * k );
+        CHECK( f("/", "(n + 1)", ks)(n) == (n + 1) / k );
+        CHECK( f("%", "(n + 1)", ks)(n) == (n + 1) % k );
+        CHECK( f("-", "(n + 1)", "1")(n) == n );
+        CHECK( f("<=", "(n + 1)", ks)(n) == (n + 1 <= k) );
+        CHECK( f("==", "(n + 1)", ks)(n) == (n + 1 == k) );
+        CHECK( f("&&", "(n + 1)", "0")(n) == 0 );
+        CHECK( f("||", "(n + 1)", "0")(n) == 1 );
+
+        CHECK( f("/", "1000", "(n + 1)")(n) == 1000 / (n + 1) );
+        CHECK( f("-", "1000", "n")(n) == 1000 - n );
+        CHECK( f("<", ks, "n")(n) == (k < n) );
+    }
+    // The conditional in the left operand isn't fused.
+    auto g = TestType::Parse("(n == 1 ? 2 : n) % 3");
+    CHECK( g(1) == 2 );
+    CHECK( g(5) == 2 );
+    CHECK( g(6) == 0 );
+}
+
+TEMPLATE_TEST_CASE( "Deep expression in PluralFunction", "[PluralFunction]", ENABLE_ASSERT::PluralParser, INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, INTERPRETER_NO_OPTIMIZATION::PluralParser ) {
+    // The stack is deeper than the local stack of the interpreter.
+    string expression = "n";
+    for (int i = 0; i < 40; ++i) {
+        expression = "1 + (" + expression + ")";
+    }
+    auto f = TestType::Parse("(" + expression + ") % 100");
+    REQUIRE( f(0) == 40 );
+    REQUIRE( f(70) == 10 );
+}
+
+TEMPLATE_TEST_CASE( "Optimization of PluralFunction", "[PluralFunction]", INTERPRETER::PluralParser, INTERPRETER_SWITCH::PluralParser, DEBUG_32BIT_ALL::PluralParser ) {
+    // The optimized program must be equivalent to the program without the optimization.
+    const char *const expressions[] = {
+        "1 + 2 * 3 - 4 / 2 % 3",
+        "n > 1 + 2 * 3",
+        "(n%10==1) ? 1 : 0",
+        "(n%10==1) ? 0 : 1",
+        "!(n < 5) ? 2 : 3",
+        "!!(n % 3) ? 2 : 3",
+        "!(n == 1 || n == 2) ? 0 : 1",
+        "!(n % 10 >= 2 && n % 10 <= 4) ? n % 100 : n % 10",
+        "5 < n ? 1 : 5 >= n + 2 ? 2 : 3",
+        "1 ? n : 2",
+        "0 ? 2 : n % 4",
+        "n * 1 + 0 - 0",
+        "n % 1 + n * 0",
+        "n && 1",
+        "n || 0",
+        "n && 0 || n % 3",
+        "n % 3 ? 1 : 1",
+        "(n % 3 ? 1 : 2) == 1 && (n % 5 || n % 7)",
+        "n%10==1 && n%100!=11 ? 0 : n%10>=2 && (n%100<10 || n%100>=20) ? 1 : 2",
+        "n%2 + n%3 + n%5 + n%7 + n%2 + n%3 + n%5 + n%7 + n%11 + n%11",
+        "n%100==1 ? 0 : n%100==2 ? 1 : n%100==3 || n%100==4 ? 2 : 3",
+        "0 - n % 7 > 1000000",
+    };
+    for (const char *expression : expressions) {
+        INFO( "expression = " << expression );
+        const auto optimized = TestType::Parse(expression);
+        const auto expected = INTERPRETER_NO_OPTIMIZATION::PluralParser::Parse(expression);
+        for (NumT n = 0; n < 300; ++n) {
+            INFO( "n = " << n );
+            REQUIRE( optimized(n) == expected(n) );
+        }
+        for (const NumT n : { 1000UL, 1011UL, 4294967295UL, 123456789012UL }) {
+            INFO( "n = " << n );
+            REQUIRE( optimized(n) == expected(n) );
+        }
+    }
+
+    SECTION( "Constant folding" ) {
+        CHECK( TestType::Parse("1 + 2 * 3")(0) == 7 );
+        CHECK( TestType::Parse("0 - 1 > 0")(0) == 1 );
+        CHECK( TestType::Parse("3 > 2 ? 4 / 2 : 1 / 0")(0) == 2 );
+    };
+    SECTION( "Division by zero isn't removed" ) {
+        // Only the branch that isn't executed may divide by zero.
+        CHECK( TestType::Parse("n ? n / n : 5")(0) == 5 );
+        CHECK( TestType::Parse("n == 0 ? 1 : 10 % n")(0) == 1 );
+        CHECK( TestType::Parse("n == 0 ? 1 : 10 % n")(3) == 1 );
+    };
+}
+
+TEMPLATE_TEST_CASE( "Lookup table of PluralFunction", "[PluralFunction]", PluralParser, ENABLE_ASSERT::PluralParser, DEBUG_32BIT_ALL::PluralParser ) {
+    // The results with the lookup table must be the same as the results of the interpreter.
+    // Some expressions aren't periodic, or their tables are too large, so they use the interpreter.
+    const char *const expressions[] = {
+        "n%7==1 ? 0 : n%7==2 ? 1 : 2",
+        "n==0 ? 0 : n%100>=3 && n%100<=10 ? 3 : n%7==1 ? 1 : 2",
+        "n % 3 + n % 5 * 3",
+        "n > 300 ? 1 : 0",
+        "n == 1000 ? 1 : n % 10 == 1 ? 2 : 0",
+        "n == 3000 ? 1 : 0",
+        "n ? 1 : 0",
+        "!n",
+        "n && n % 2",
+        "n % 999 == 998",
+        "n % 999 == 998 || n % 10 == 1",
+        "n % 100 * 3",
+        "n / 10 % 10 == 1",
+        "(n + 1) % 10 == 0",
+        "5 <= n && 10 > n",
+        "n % 10 == 0 ? 0 : 10 / (n % 10)",
+        "2",
+    };
+    for (const char *expression : expressions) {
+        INFO( "expression = " << expression );
+        const auto f = TestType::Parse(expression);
+        const auto expected = INTERPRETER::PluralParser::Parse(expression);
+        for (NumT n = 0; n < 4000; ++n) {
+            INFO( "n = " << n );
+            REQUIRE( f(n) == expected(n) );
+        }
+        for (const NumT n : { 99999UL, 1000000UL, 4294967295UL, 4294967296UL, 123456789012UL }) {
+            INFO( "n = " << n );
+            REQUIRE( f(n) == expected(n) );
+        }
+    }
+}
+
+TEST_CASE( "PluralFunction is thread-safe", "[PluralFunction]" ) {
+    // The interpreter has no shared state.
+    const auto f = INTERPRETER::PluralParser::Parse(plural_forms[21]);
+    vector<size_t> mismatches(4, 0);
+    vector<thread> threads;
+    for (size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&f, &mismatches, t]() {
+            for (NumT n = 0; n < 100000; ++n) {
+                if (f(n) != compiled_plural_funcs[21](n)) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto &it : threads) {
+        it.join();
+    }
+    for (const auto m : mismatches) {
+        CHECK( m == 0 );
+    }
+}
 
 // For some reason, "g++ -D_GLIBCXX_DEBUG" causes some errors in BENCHMARK()...
 #ifdef ENABLE_BENCHMARK
@@ -0,0 +1,62 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "spiritless_po.h"
+#include "PoCorpusGenerator.h"
+
+using namespace std;
+using namespace spiritless_po;
+
+TEST_CASE( "PoCorpusGenerator is deterministic", "[PoCorpusGenerator]" ) {
+    po_corpus::OptionsT options;
+    options.entries = 2000;
+    po_corpus::PoCorpusGenerator generator(options);
+    const string text = generator.Generate();
+    REQUIRE( generator.Generate() == text );
+    REQUIRE( po_corpus::PoCorpusGenerator(options).Generate() == text );
+
+    string chunked;
+    generator.Generate([&chunked](const string &chunk) {
+        chunked += chunk;
+    }, 4096);
+    REQUIRE( chunked == text );
+
+    options.seed = 2;
+    REQUIRE( po_corpus::PoCorpusGenerator(options).Generate() != text );
+}
+
+TEST_CASE( "PoCorpusGenerator makes the entries by the options", "[PoCorpusGenerator]" ) {
+    po_corpus::OptionsT options;
+    options.entries = 5000;
+    options.nplurals = 3;
+    options.escapeRatio = 0.2;
+    options.contextRatio = 0.2;
+    options.pluralRatio = 0.3;
+    options.fuzzyRatio = 0.1;
+    options.errorRatio = 0.05;
+    for (const auto distribution : { po_corpus::LengthDistributionT::UNIFORM, po_corpus::LengthDistributionT::EXPONENTIAL }) {
+        options.lengthDistribution = distribution;
+        po_corpus::PoCorpusGenerator generator(options);
+        const string text = generator.Generate();
+        const po_corpus::CountsT &counts = generator.GetCounts();
+        REQUIRE( counts.entries == options.entries + 1 );
+        REQUIRE( counts.contexts > 0 );
+        REQUIRE( counts.plurals > 0 );
+        REQUIRE( counts.fuzzy > 0 );
+        REQUIRE( counts.errors > 0 );
+
+        const Catalog catalog(text.begin(), text.end());
+        const auto &statistics = catalog.GetStatistics();
+        REQUIRE( catalog.GetError().size() == counts.errors );
+        REQUIRE( statistics.totalCount == counts.entries - counts.errors );
+        REQUIRE( statistics.metadataCount == 1 );
+        REQUIRE( statistics.translatedCount == counts.entries - counts.errors - counts.fuzzy );
+        REQUIRE( statistics.discardedCount == 0 );
+        REQUIRE( catalog.GetMetadata().at("Plural-Forms") == "nplurals=3; plural=n%3;" );
+    }
+}
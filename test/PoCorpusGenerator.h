@@ -0,0 +1,286 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// Synthetic PO corpus generator for the benchmarks.
+// The same options and the same seed generate the same text on any platform, because it doesn't use the distributions of <random>.
+
+#ifndef SPIRITLESS_PO_TEST_PO_CORPUS_GENERATOR_H_
+#define SPIRITLESS_PO_TEST_PO_CORPUS_GENERATOR_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace po_corpus {
+    // Distribution of the length of msgid.
+    enum class LengthDistributionT {
+        UNIFORM, // Uniform in [minLength, maxLength].
+        EXPONENTIAL, // minLength + exponential with the mean meanLength - minLength, clipped at maxLength.
+    };
+
+    // Options of the corpus.
+    struct OptionsT {
+        OptionsT();
+
+        std::uint64_t seed; // The seed of the random numbers.
+        std::size_t entries; // The number of the entries, except for the header.
+        bool header; // Generate the header entry.
+        unsigned int nplurals; // nplurals in the header, and the number of msgstr[n].
+        LengthDistributionT lengthDistribution; // The distribution of the length of msgid.
+        std::size_t minLength; // The minimum length of msgid.
+        std::size_t meanLength; // The mean length of msgid for EXPONENTIAL.
+        std::size_t maxLength; // The maximum length of msgid.
+        double escapeRatio; // The ratio of the escape sequences to the words.
+        double contextRatio; // The ratio of the entries that have msgctxt.
+        double pluralRatio; // The ratio of the entries that have msgid_plural.
+        double fuzzyRatio; // The ratio of the fuzzy entries.
+        double commentRatio; // The ratio of the entries that have the comments.
+        double errorRatio; // The ratio of the malformed entries.
+    };
+
+    // Counts of the generated entries.
+    struct CountsT {
+        std::size_t entries; // The number of the entries, including the header and the malformed entries.
+        std::size_t contexts; // The number of the entries that have msgctxt.
+        std::size_t plurals; // The number of the entries that have msgid_plural.
+        std::size_t fuzzy; // The number of the fuzzy entries.
+        std::size_t errors; // The number of the malformed entries.
+    };
+
+    // The generator of a PO corpus.
+    class PoCorpusGenerator {
+    public:
+        explicit PoCorpusGenerator(const OptionsT &options = OptionsT());
+
+        // Generate the whole corpus.
+        std::string Generate();
+
+        // Generate the corpus, and pass it to sink(const std::string &chunk) by the chunks of about chunkSize bytes.
+        // A huge corpus can be written without holding the whole text.
+        template <typename Sink>
+        void Generate(Sink &&sink, std::size_t chunkSize = 1024 * 1024);
+
+        // Get the counts of the last generated corpus.
+        const CountsT &GetCounts() const noexcept;
+
+    private:
+        std::uint64_t Next();
+        std::size_t NextIndex(std::size_t n);
+        bool NextBool(double ratio);
+        std::size_t NextLength();
+        std::string MakeText(std::size_t length, const char *prefix, std::size_t id);
+        void AppendQuoted(std::string &out, const char *keyword, const std::string &text);
+        void AppendEntry(std::string &out, std::size_t id);
+        void AppendHeader(std::string &out);
+
+        OptionsT options;
+        std::mt19937_64 engine;
+        CountsT counts;
+    };
+
+    inline OptionsT::OptionsT()
+        : seed(1), entries(1000), header(true), nplurals(2),
+          lengthDistribution(LengthDistributionT::EXPONENTIAL), minLength(4), meanLength(30), maxLength(300),
+          escapeRatio(0.02), contextRatio(0.05), pluralRatio(0.05), fuzzyRatio(0.02), commentRatio(0.5), errorRatio(0.0)
+    {
+    }
+
+    inline PoCorpusGenerator::PoCorpusGenerator(const OptionsT &options)
+        : options(options), engine(options.seed), counts{}
+    {
+    }
+
+    inline std::string PoCorpusGenerator::Generate()
+    {
+        std::string text;
+        Generate([&text](const std::string &chunk) {
+            text += chunk;
+        }, static_cast<std::size_t>(-1));
+        return text;
+    }
+
+    template <typename Sink>
+    void PoCorpusGenerator::Generate(Sink &&sink, const std::size_t chunkSize)
+    {
+        engine.seed(options.seed);
+        counts = CountsT{};
+        std::string chunk;
+        if (options.header) {
+            AppendHeader(chunk);
+        }
+        for (std::size_t i = 0; i < options.entries; ++i) {
+            if (i > 0 || options.header) {
+                chunk += '\n';
+            }
+            AppendEntry(chunk, i);
+            if (chunk.size() >= chunkSize) {
+                sink(chunk);
+                chunk.clear();
+            }
+        }
+        if (!chunk.empty()) {
+            sink(chunk);
+        }
+    }
+
+    inline const CountsT &PoCorpusGenerator::GetCounts() const noexcept
+    {
+        return counts;
+    }
+
+    inline std::uint64_t PoCorpusGenerator::Next()
+    {
+        return engine();
+    }
+
+    inline std::size_t PoCorpusGenerator::NextIndex(const std::size_t n)
+    {
+        return static_cast<std::size_t>(Next() % n);
+    }
+
+    inline bool PoCorpusGenerator::NextBool(const double ratio)
+    {
+        // 53 bits are enough for a double in [0, 1).
+        return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0) < ratio;
+    }
+
+    inline std::size_t PoCorpusGenerator::NextLength()
+    {
+        const std::size_t minLength = options.minLength;
+        const std::size_t maxLength = options.maxLength < minLength ? minLength : options.maxLength;
+        if (options.lengthDistribution == LengthDistributionT::UNIFORM) {
+            return minLength + NextIndex(maxLength - minLength + 1);
+        }
+        const double u = (static_cast<double>(Next() >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+        const double mean = options.meanLength > minLength ? static_cast<double>(options.meanLength - minLength) : 1.0;
+        const double len = static_cast<double>(minLength) - mean * std::log(u);
+        return len >= static_cast<double>(maxLength) ? maxLength : static_cast<std::size_t>(len);
+    }
+
+    // Make a text that consists of the words, and is unique by id.
+    inline std::string PoCorpusGenerator::MakeText(const std::size_t length, const char *const prefix, const std::size_t id)
+    {
+        static const char *const syllables[] = {
+            "ka", "lo", "mi", "ne", "ru", "sa", "to", "vi", "an", "el", "or", "us", "tra", "pel", "qui", "sto",
+        };
+        static const char *const escapes[] = {
+            "\\n", "\\t", "\\\"", "\\\\", "\\x41", "\\101",
+        };
+        std::string text(prefix);
+        text += std::to_string(id);
+        while (text.size() < length) {
+            text += ' ';
+            if (NextBool(options.escapeRatio)) {
+                text += escapes[NextIndex(sizeof(escapes) / sizeof(escapes[0]))];
+            }
+            const std::size_t n = 1 + NextIndex(3);
+            for (std::size_t i = 0; i < n; ++i) {
+                text += syllables[NextIndex(sizeof(syllables) / sizeof(syllables[0]))];
+            }
+        }
+        return text;
+    }
+
+    // Append 'keyword "text"', splitting the long text into the lines as msgcat does.
+    inline void PoCorpusGenerator::AppendQuoted(std::string &out, const char *const keyword, const std::string &text)
+    {
+        const std::size_t width = 70;
+        out += keyword;
+        if (text.size() <= width) {
+            out += " \"";
+            out += text;
+            out += "\"\n";
+            return;
+        }
+        out += " \"\"\n";
+        std::size_t start = 0;
+        while (start < text.size()) {
+            std::size_t end = start + width;
+            if (end >= text.size()) {
+                end = text.size();
+            } else {
+                // Split after a space, which isn't in an escape sequence.
+                const std::size_t space = text.rfind(' ', end);
+                end = space != std::string::npos && space > start ? space + 1 : text.size();
+            }
+            out += '"';
+            out.append(text, start, end - start);
+            out += "\"\n";
+            start = end;
+        }
+    }
+
+    inline void PoCorpusGenerator::AppendHeader(std::string &out)
+    {
+        ++counts.entries;
+        out += "# Synthetic PO corpus.\nmsgid \"\"\nmsgstr \"\"\n"
+            "\"Project-Id-Version: po-corpus\\n\"\n"
+            "\"Language: xx\\n\"\n"
+            "\"MIME-Version: 1.0\\n\"\n"
+            "\"Content-Type: text/plain; charset=UTF-8\\n\"\n"
+            "\"Content-Transfer-Encoding: 8bit\\n\"\n"
+            "\"Plural-Forms: nplurals=";
+        out += std::to_string(options.nplurals);
+        out += "; plural=n%";
+        out += std::to_string(options.nplurals);
+        out += ";\\n\"\n";
+    }
+
+    inline void PoCorpusGenerator::AppendEntry(std::string &out, const std::size_t id)
+    {
+        ++counts.entries;
+        if (NextBool(options.commentRatio)) {
+            out += "#. Extracted comment.\n#: src/file";
+            out += std::to_string(NextIndex(100));
+            out += ".c:";
+            out += std::to_string(1 + NextIndex(5000));
+            out += '\n';
+        }
+        if (NextBool(options.errorRatio)) {
+            ++counts.errors;
+            switch (NextIndex(3)) {
+            case 0:
+                // Invalid n of msgstr[n].
+                out += "msgid \"error" + std::to_string(id) + "\"\nmsgstr[1] \"ERROR\"\n";
+                break;
+            case 1:
+                // Invalid escape sequence.
+                out += "msgid \"error" + std::to_string(id) + "\\q\"\nmsgstr \"ERROR\"\n";
+                break;
+            default:
+                // No msgstr.
+                out += "msgid \"error" + std::to_string(id) + "\"\n";
+                break;
+            }
+            return;
+        }
+        if (NextBool(options.fuzzyRatio)) {
+            ++counts.fuzzy;
+            out += "#, fuzzy\n";
+        }
+        if (NextBool(options.contextRatio)) {
+            ++counts.contexts;
+            out += "msgctxt \"context";
+            out += std::to_string(NextIndex(100));
+            out += "\"\n";
+        }
+        const std::size_t length = NextLength();
+        AppendQuoted(out, "msgid", MakeText(length, "id", id));
+        if (NextBool(options.pluralRatio) && options.nplurals > 0) {
+            ++counts.plurals;
+            AppendQuoted(out, "msgid_plural", MakeText(length, "ids", id));
+            for (unsigned int i = 0; i < options.nplurals; ++i) {
+                const std::string keyword = "msgstr[" + std::to_string(i) + ']';
+                AppendQuoted(out, keyword.c_str(), MakeText(length, "STR", id));
+            }
+        } else {
+            AppendQuoted(out, "msgstr", MakeText(length, "STR", id));
+        }
+    }
+} // namespace po_corpus
+
+#endif // SPIRITLESS_PO_TEST_PO_CORPUS_GENERATOR_H_
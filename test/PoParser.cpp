@@ -4,7 +4,10 @@
   See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
 */
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
 
 #include "spiritless_po/PoParser.h"
@@ -5239,3 +5242,324 @@ TEST_CASE( "too many white spaces", "[PoParser]" ) {
         REQUIRE( equal(entries[2], create("cc" "\x04" "c", { "C0", "C1" }, "")) );
     }
 }
+
+
+namespace {
+    const string incremental_test_texts[] = {
+        R"(# translator-comments
+#, fuzzy
+msgid ""
+msgstr "Project-Id-Version: test-data\n"
+
+msgid "apples"
+msgstr "APPLES"
+
+#, c-format, fuzzy
+msgid "fuzzy"
+msgstr "FUZZY"
+
+msgctxt "food"
+msgid "corn"
+msgid_plural "corns"
+msgstr [ 0 ] "CORN#0"
+"CORN#0"
+msgstr
+[
+1
+]
+"CORN#1"
+)",
+        R"(
+msgid "apples"
+msgctxt "food"
+msgstr "APPLES"
+
+msgid "bananas"
+msgstr[0] "BANANAS"
+
+msgid_plural "corns"
+msgid "corn"
+msgstr[0] "CORNS#0"
+
+msgid "hops"
+msgstr[1] "HOPS"
+
+msgid "a\qb" "c
+msgstr "A\x"
+
+msgid "d" unknown
+msgstr "D"
+
+msgid "eggs")",
+        R"(msgid "a"
+msgstr "A\101\x42\t")",
+        "msgid \"a\"\nmsgstr \"A",
+        "",
+        R"(msgid "a\\b\"c\101\7\12d\x4\x41\x0000000000000042e\x4142434445464748\nf\x"
+msgstr "abcdefghijklmnopqrstuvwxyz" "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+# a comment
+"abcdefghijklmnopqrstuvwxyz\q" "abcdefghijklmnopqrstuvwxyz"
+msgid "b"
+msgstr "abcdefghijklmnopqrstuvwxyz\qabcdefghijklmnopqrstuvwxyz\q" unknown
+
+msgid "c"
+msgstr "abcdefghijklmnopqrstuvwxyz\\" "\
+msgid "d"
+msgstr "abcdefghijklmnopqrstuvwxyz\x41424344")",
+    };
+
+    vector<PoParser::PoEntryT> feed_in_chunks(const string &text, size_t chunkSize)
+    {
+        PoParser::IncrementalParser parser;
+        vector<PoParser::PoEntryT> entries;
+        for (size_t i = 0; i < text.size(); i += chunkSize) {
+            auto newEntries = parser.Feed(text.data() + i, min(chunkSize, text.size() - i));
+            entries.insert(entries.end(), newEntries.begin(), newEntries.end());
+        }
+        auto newEntries = parser.Finish();
+        entries.insert(entries.end(), newEntries.begin(), newEntries.end());
+        return entries;
+    }
+}
+
+TEST_CASE( "Incremental parser is equal to GetEntries()", "[PoParser]" ) {
+    for (const auto &text : incremental_test_texts) {
+        const auto expected = PoParser::GetEntries(text.begin(), text.end());
+        for (size_t chunkSize = 1; chunkSize <= text.size() + 1; ++chunkSize) {
+            const auto entries = feed_in_chunks(text, chunkSize);
+            REQUIRE( entries.size() == expected.size() );
+            for (size_t i = 0; i < entries.size(); ++i) {
+                REQUIRE( equal(entries[i], expected[i]) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Incremental parser with a long quoted text", "[PoParser]" ) {
+    // The decoded part of a text is kept, so the text isn't lexed again for each chunk.
+    string run;
+    for (size_t i = 0; run.size() < 4 * 1024 * 1024; ++i) {
+        run += "abcdefghijklmnopqrstuvwxyz\\t\\101\\x4a" + to_string(i);
+    }
+    const string po_text = "msgid \"a\"\nmsgstr \"" + run + "\"\n\nmsgid \"b\"\nmsgstr \"\\x" + string(1024 * 1024, '4') + "1\"\n";
+    const auto expected = PoParser::GetEntries(po_text.begin(), po_text.end());
+    REQUIRE( expected.size() == 2 );
+    REQUIRE( expected[0].error.empty() );
+    REQUIRE( expected[1].msgstr == vector<string>{ "A" } );
+    const auto start = chrono::steady_clock::now();
+    for (size_t chunkSize : { 1024, 1500, 4096 }) {
+        const auto entries = feed_in_chunks(po_text, chunkSize);
+        REQUIRE( entries.size() == expected.size() );
+        for (size_t i = 0; i < entries.size(); ++i) {
+            REQUIRE( equal(entries[i], expected[i]) );
+        }
+    }
+    // Lexing the text again for each chunk takes minutes.
+    REQUIRE( chrono::steady_clock::now() - start < chrono::seconds(20) );
+}
+
+TEST_CASE( "Incremental parser is reusable after Finish()", "[PoParser]" ) {
+    const string po_text = R"(msgid "apples"
+msgstr "APPLES"
+)";
+    PoParser::IncrementalParser parser;
+    auto entries1 = parser.Feed(po_text.data(), po_text.size());
+    auto rest1 = parser.Finish();
+    auto entries2 = parser.Feed(po_text.data(), po_text.size());
+    auto rest2 = parser.Finish();
+    REQUIRE( entries1.size() == 0 );
+    REQUIRE( entries2.size() == 0 );
+    REQUIRE( rest1.size() == 1 );
+    REQUIRE( rest2.size() == 1 );
+    REQUIRE( equal(rest1[0], create("apples", { "APPLES" }, "")) );
+    REQUIRE( equal(rest2[0], create("apples", { "APPLES" }, "")) );
+}
+
+TEST_CASE( "Long quoted text and comment", "[PoParser]" ) {
+    // The special characters are at every offset of the blocks that are scanned at once.
+    for (size_t len = 0; len < 80; ++len) {
+        const string run(len, 'a');
+        const string po_text = "# " + run + "\n#, " + run + "\nmsgid \"" + run + "\\t" + run + "\"\nmsgstr \"" + run + "\\\"" + run + "\"\n"
+            + "msgid \"" + run + "\nmsgstr \"" + run + "\"\n";
+        istringstream is(po_text);
+        const auto expected = PoParser::GetEntries(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+        const auto entries = PoParser::GetEntries(po_text.begin(), po_text.end());
+        REQUIRE( expected.size() == 2 );
+        REQUIRE( equal(expected[0], create(run + "\t" + run, { run + "\"" + run }, "")) );
+        REQUIRE( expected[1].error == "5," + to_string(len + 8) + ": The text may not contain a newline." );
+        REQUIRE( entries.size() == expected.size() );
+        for (size_t i = 0; i < entries.size(); ++i) {
+            REQUIRE( equal(entries[i], expected[i]) );
+        }
+    }
+}
+
+TEST_CASE( "GetEntries() by contiguous chars is equal to by input iterator", "[PoParser]" ) {
+    for (const auto &text : incremental_test_texts) {
+        istringstream is(text);
+        const auto expected = PoParser::GetEntries(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+        string::const_iterator it = text.begin();
+        const auto entries = PoParser::GetEntries(it, text.end());
+        REQUIRE( it == text.end() );
+        REQUIRE( entries.size() == expected.size() );
+        for (size_t i = 0; i < entries.size(); ++i) {
+            REQUIRE( equal(entries[i], expected[i]) );
+        }
+    }
+}
+
+
+namespace {
+    // This function returns a PO text that is larger than the minimum chunk size of GetEntriesParallel().
+    string gen_large_po_text(size_t nEntries)
+    {
+        string text;
+        for (size_t i = 0; i < nEntries; ++i) {
+            const string n = to_string(i);
+            switch (i % 8) {
+            case 0:
+                text += "#, fuzzy\n\nmsgid \"fuzzy" + n + "\"\nmsgstr \"FUZZY" + n + "\"\n\n";
+                break;
+            case 1:
+                text += "msgctxt \"ctxt\"\n\nmsgid \"ctxt" + n + "\"\nmsgstr \"CTXT" + n + "\"\n\n";
+                break;
+            case 2:
+                text += "msgid \"plural" + n + "\"\nmsgid_plural \"plurals\"\nmsgstr[0] \"P0\"\n\nmsgstr[1] \"P1\"\n\n";
+                break;
+            case 3:
+                text += "msgid \"error" + n + "\"\nmsgstr[\n\nmsgid \"skipped\"\nmsgstr \"SKIPPED\"\n\n";
+                break;
+            case 4:
+                text += "msgid \"incomplete" + n + "\"\n\n";
+                break;
+            default:
+                text += "# comment\nmsgid \"id" + n + "\"\nmsgstr \"ID" + n + "\"\n\"\\t\\x41\"\n\n";
+                break;
+            }
+        }
+        return text;
+    }
+}
+
+TEST_CASE( "GetEntriesParallel() is equal to GetEntries()", "[PoParser]" ) {
+    const string po_text = gen_large_po_text(60000);
+    const auto expected = PoParser::GetEntries(po_text.begin(), po_text.end());
+    for (unsigned int threads : { 1U, 2U, 3U, 8U }) {
+        const auto entries = PoParser::GetEntriesParallel(po_text.data(), po_text.data() + po_text.size(), threads);
+        REQUIRE( entries.size() == expected.size() );
+        for (size_t i = 0; i < entries.size(); ++i) {
+            REQUIRE( equal(entries[i], expected[i]) );
+        }
+    }
+}
+
+TEST_CASE( "GetEntriesParallel() with no boundary", "[PoParser]" ) {
+    const string po_text = string(3 * 1024 * 1024, '\n') + "msgid \"a\"\nmsgstr \"A\"\n" + string(2 * 1024 * 1024, '#');
+    const auto expected = PoParser::GetEntries(po_text.begin(), po_text.end());
+    const auto entries = PoParser::GetEntriesParallel(po_text.data(), po_text.data() + po_text.size(), 4);
+    REQUIRE( entries.size() == expected.size() );
+    for (size_t i = 0; i < entries.size(); ++i) {
+        REQUIRE( equal(entries[i], expected[i]) );
+    }
+}
+
+namespace {
+    // Compare an entry in the columnar form with PoEntryT.
+    bool equal(const PoParser::EntryTableT &table, const PoParser::EntryTableT::EntryT &a, const PoParser::PoEntryT &b)
+    {
+        using EntryTableT = PoParser::EntryTableT;
+        if ((a.flags & EntryTableT::FLAG_ERROR) != 0) {
+            return a.msgid.size == 0 && a.msgstrCount == 0 && b.msgid.empty() && b.msgstr.empty() && table.errors[a.errorIndex] == b.error;
+        }
+        if (!b.error.empty() || table.text.compare(a.msgid.offset, a.msgid.size, b.msgid) != 0 || a.msgstrCount != b.msgstr.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.msgstrCount; ++i) {
+            const auto &range = table.msgstrs[a.msgstrIndex + i];
+            if (table.text.compare(range.offset, range.size, b.msgstr[i]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE( "GetEntryTable() is equal to GetEntries()", "[PoParser]" ) {
+    vector<string> texts(begin(incremental_test_texts), end(incremental_test_texts));
+    texts.push_back(gen_large_po_text(1000));
+    texts.push_back("#, fuzzy\nmsgid \"a\"\nmsgstr \"A\"\n\nmsgid \"b\"\nmsgstr \"B\"\n");
+    for (const auto &text : texts) {
+        const auto expected = PoParser::GetEntries(text.begin(), text.end());
+        const auto table = PoParser::GetEntryTable(text.begin(), text.end());
+        REQUIRE( table.entries.size() == expected.size() );
+        for (size_t i = 0; i < expected.size(); ++i) {
+            REQUIRE( equal(table, table.entries[i], expected[i]) );
+        }
+        istringstream is(text);
+        const auto table2 = PoParser::GetEntryTable(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+        REQUIRE( table2.text == table.text );
+        REQUIRE( table2.entries.size() == expected.size() );
+        for (size_t i = 0; i < expected.size(); ++i) {
+            REQUIRE( equal(table2, table2.entries[i], expected[i]) );
+        }
+    }
+}
+
+TEST_CASE( "GetEntryTable() flags", "[PoParser]" ) {
+    using EntryTableT = PoParser::EntryTableT;
+    const string text = "#, fuzzy\nmsgid \"a\"\nmsgstr \"A\"\n\nmsgid \"b\"\nmsgstr[x] \"B\"\n\nmsgctxt \"c\"\nmsgid \"d\"\nmsgid_plural \"e\"\nmsgstr[0] \"D\"\nmsgstr[1] \"E\"\n";
+    const auto table = PoParser::GetEntryTable(text.begin(), text.end());
+    REQUIRE( table.entries.size() == 3 );
+    REQUIRE( table.errors.size() == 1 );
+    REQUIRE( table.entries[0].flags == EntryTableT::FLAG_FUZZY );
+    REQUIRE( table.entries[1].flags == EntryTableT::FLAG_ERROR );
+    REQUIRE( table.entries[1].errorIndex == 0 );
+    REQUIRE( table.entries[2].flags == 0 );
+    REQUIRE( table.entries[2].msgstrCount == 2 );
+    REQUIRE( table.text == string("a") + "A" + "c" + CONTEXT_SEPARATOR + "d" + "D" + "E" );
+}
+
+TEST_CASE( "GetIndexEntries() and DecodeMsgstr() are equal to GetEntries()", "[PoParser]" ) {
+    vector<string> texts(begin(incremental_test_texts), end(incremental_test_texts));
+    texts.push_back(gen_large_po_text(1000));
+    texts.push_back("#, fuzzy\nmsgid \"a\"\nmsgstr \"A\"\n\nmsgid \"b\"\nmsgstr \"\"\n\"B\"\n");
+    // The msgstr texts are checked without decoding them.
+    texts.push_back(R"(msgid "a"
+msgstr "" "" "\x41" "\101\"\\"
+
+msgid "b"
+msgstr "B\q" "C"
+
+msgid "c"
+msgstr[0] ""
+msgstr[1] "\x"
+
+msgid "d"
+msgstr "D
+msgstr "D"
+
+msgid "e"
+msgstr "E)");
+    for (const auto &text : texts) {
+        const auto expected = PoParser::GetEntries(text.begin(), text.end());
+        const auto entries = PoParser::GetIndexEntries(text.data(), text.data() + text.size());
+        REQUIRE( entries.size() == expected.size() );
+        for (size_t i = 0; i < expected.size(); ++i) {
+            REQUIRE( entries[i].error == expected[i].error );
+            if (!expected[i].error.empty()) {
+                REQUIRE( entries[i].msgid.empty() );
+                REQUIRE( entries[i].msgstrBegin == nullptr );
+                continue;
+            }
+            REQUIRE( entries[i].msgid == expected[i].msgid );
+            REQUIRE( entries[i].msgstrCount == expected[i].msgstr.size() );
+            REQUIRE( entries[i].isMsgstr0Empty == expected[i].msgstr[0].empty() );
+            vector<string> msgstr = PoParser::DecodeMsgstr(entries[i].msgstrBegin, entries[i].msgstrEnd);
+            if (entries[i].isMsgstr0Empty) {
+                msgstr[0].clear();
+            }
+            REQUIRE( msgstr == expected[i].msgstr );
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "spiritless_po.h"
+
+using namespace std;
+using namespace spiritless_po;
+
+namespace {
+    string write_entries(const vector<PoParser::PoEntryT> &entries, size_t wrapWidth = 0)
+    {
+        ostringstream os;
+        PoWriter::OptionsT options;
+        options.wrapWidth = wrapWidth;
+        PoWriter writer(os, options);
+        for (const auto &entry : entries) {
+            writer.Write(entry);
+        }
+        writer.Flush();
+        return os.str();
+    }
+
+    PoParser::PoEntryT entry(const string &msgid, const vector<string> &msgstr)
+    {
+        PoParser::PoEntryT e;
+        e.msgid = msgid;
+        e.msgstr = msgstr;
+        return e;
+    }
+
+    PoParser::PoEntryT entry(const string &msgid, const string &msgid_plural, const vector<string> &msgstr)
+    {
+        PoParser::PoEntryT e = entry(msgid, msgstr);
+        e.msgid_plural = msgid_plural;
+        return e;
+    }
+
+    // A stream buffer that fails to write.
+    class BrokenBuffer : public streambuf {
+    protected:
+        int_type overflow(int_type) override
+        {
+            return traits_type::eof();
+        }
+        streamsize xsputn(const char *, streamsize) override
+        {
+            return 0;
+        }
+    };
+}
+
+TEST_CASE( "PoWriter writes the entries", "[PoWriter]" ) {
+    const vector<PoParser::PoEntryT> entries = {
+        entry("", { "Language: xx\nPlural-Forms: nplurals=2; plural=n!=1;\n" }),
+        entry("apple", { "APPLE" }),
+        entry(string("food") + CONTEXT_SEPARATOR + "egg", "eggs", { "EGG#0", "EGG#1" }),
+        entry("esc", { string("\"\\\t\r\a\b\f\v") + '\0' + '\x01' + '\x1F' + "x\n" }),
+    };
+    const string expected = R"(msgid ""
+msgstr ""
+"Language: xx\n"
+"Plural-Forms: nplurals=2; plural=n!=1;\n"
+
+msgid "apple"
+msgstr "APPLE"
+
+msgctxt "food"
+msgid "egg"
+msgid_plural "eggs"
+msgstr[0] "EGG#0"
+msgstr[1] "EGG#1"
+
+msgid "esc"
+msgstr "\"\\\t\r\a\b\f\v\000\001\037x\n"
+)";
+    REQUIRE( write_entries(entries) == expected );
+    const auto parsed = PoParser::GetEntries(expected.begin(), expected.end());
+    REQUIRE( parsed.size() == entries.size() );
+    for (size_t i = 0; i < entries.size(); ++i) {
+        REQUIRE( parsed[i].msgid == entries[i].msgid );
+        REQUIRE( parsed[i].msgid_plural == entries[i].msgid_plural );
+        REQUIRE( parsed[i].msgstr == entries[i].msgstr );
+    }
+}
+
+TEST_CASE( "PoWriter doesn't make msgid_plural and msgstr", "[PoWriter]" ) {
+    ostringstream os;
+    PoWriter writer(os);
+    writer.Write("a", {});
+    writer.Write("b", { "B#0", "B#1" });
+    writer.Write("c", "cs", { "C#0" });
+    writer.Write("d", "ds", {});
+    writer.Write(entry("e", "", { "E#0" }));
+    writer.Flush();
+    REQUIRE( os.str() == R"(msgid "a"
+msgstr ""
+
+msgid "b"
+msgid_plural ""
+msgstr[0] "B#0"
+msgstr[1] "B#1"
+
+msgid "c"
+msgid_plural "cs"
+msgstr[0] "C#0"
+
+msgid "d"
+msgid_plural "ds"
+msgstr[0] ""
+
+msgid "e"
+msgstr "E#0"
+)" );
+}
+
+TEST_CASE( "PoWriter with a broken stream", "[PoWriter]" ) {
+    BrokenBuffer buf;
+    ostream os(&buf);
+    os.exceptions(ios::badbit);
+    {
+        PoWriter writer(os);
+        writer.Write("a", { "A" });
+        REQUIRE_THROWS_AS( writer.Flush(), ios::failure );
+        writer.Write("b", { "B" });
+        // The destructor ignores the error.
+    }
+    REQUIRE( os.bad() );
+}
+
+TEST_CASE( "PoWriter skips the error entry", "[PoWriter]" ) {
+    PoParser::PoEntryT error;
+    error.error = "error";
+    REQUIRE( write_entries({ error, entry("a", { "A" }) }) == "msgid \"a\"\nmsgstr \"A\"\n" );
+}
+
+TEST_CASE( "PoWriter wraps the lines", "[PoWriter]" ) {
+    const string text = "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.";
+    const string written = write_entries({ entry("a", { text }) }, 30);
+    REQUIRE( written == R"(msgid "a"
+msgstr ""
+"The quick brown fox jumps "
+"over the lazy dog. The "
+"quick brown fox jumps over "
+"the lazy dog."
+)" );
+    istringstream is(written);
+    string line;
+    while (getline(is, line)) {
+        REQUIRE( line.size() <= 30 + string("msgstr ").size() );
+    }
+    const auto parsed = PoParser::GetEntries(written.begin(), written.end());
+    REQUIRE( parsed[0].msgstr[0] == text );
+
+    // No wrapping.
+    REQUIRE( write_entries({ entry("a", { text }) }) == "msgid \"a\"\nmsgstr \"" + text + "\"\n" );
+}
+
+TEST_CASE( "PoWriter writes a catalog", "[PoWriter]" ) {
+    string text = "msgid \"\"\nmsgstr \"Plural-Forms: nplurals=3; plural=n%3;\\n\"\n";
+    for (int i = 0; i < 20000; ++i) {
+        const string n = to_string(i);
+        if (i % 3 == 0) {
+            text += "\nmsgctxt \"c" + n + "\"\nmsgid \"p" + n + "\"\nmsgid_plural \"ps\"\nmsgstr[0] \"P0\"\nmsgstr[1] \"P1 " + n + "\"\nmsgstr[2] \"P2\"\n";
+        } else {
+            text += "\nmsgid \"key " + n + "\"\nmsgstr \"value\\n" + n + "\"\n";
+        }
+    }
+    const Catalog catalog(text.begin(), text.end());
+    ostringstream os;
+    {
+        PoWriter writer(os);
+        writer.Write(catalog);
+    }
+    const string written = os.str();
+    const Catalog reread(written.begin(), written.end());
+    REQUIRE( reread.GetError().empty() );
+    REQUIRE( reread.GetMetadata() == catalog.GetMetadata() );
+    REQUIRE( reread.GetStringTable() == catalog.GetStringTable() );
+    REQUIRE( reread.GetIndex().size() == catalog.GetIndex().size() );
+    for (const auto &it : catalog.GetIndex()) {
+        const auto &idx = reread.GetIndex().at(it.first);
+        REQUIRE( idx.stringTableIndex == it.second.stringTableIndex );
+        REQUIRE( idx.totalPlurals == it.second.totalPlurals );
+    }
+    REQUIRE( written.compare(0, 9, "msgid \"\"\n") == 0 );
+}
@@ -0,0 +1,339 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// Compare two results of bench_json, and report the significant regressions.
+// A benchmark regresses if the mean time increases more than the threshold and Welch's t statistic is larger than the limit, or if the allocations per iteration increase.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    void usage(ostream &os)
+    {
+        os << "Usage: bench_compare [options] base.json new.json" << endl
+           << "  --threshold P       The minimum increase of the mean time in percent to be a regression. (5)" << endl
+           << "  --t T               The minimum Welch's t statistic to be a regression. (3)" << endl
+           << "Exit status: 0 if no regression, 1 if some regressions, 2 for the other errors." << endl;
+    }
+
+    // A value of JSON.
+    struct JsonT {
+        enum class TypeT { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+        TypeT type = TypeT::NUL;
+        double number = 0;
+        string text;
+        vector<JsonT> array;
+        vector<pair<string, JsonT>> object;
+
+        const JsonT *Find(const string &key) const
+        {
+            for (const auto &it : object) {
+                if (it.first == key) {
+                    return &it.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    // A small JSON parser. It throws runtime_error for an error.
+    class JsonParser {
+    public:
+        explicit JsonParser(const string &s)
+            : p(s.data()), end(s.data() + s.size())
+        {
+        }
+
+        JsonT Parse()
+        {
+            JsonT value = ParseValue();
+            SkipSpaces();
+            if (p != end) {
+                throw runtime_error("Extra characters after the JSON value.");
+            }
+            return value;
+        }
+
+    private:
+        void SkipSpaces()
+        {
+            while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+                ++p;
+            }
+        }
+
+        void Expect(char c)
+        {
+            SkipSpaces();
+            if (p == end || *p != c) {
+                throw runtime_error(string("'") + c + "' is expected.");
+            }
+            ++p;
+        }
+
+        bool Accept(char c)
+        {
+            SkipSpaces();
+            if (p != end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+
+        bool AcceptWord(const char *word)
+        {
+            const char *q = p;
+            for (const char *w = word; *w != '\0'; ++w, ++q) {
+                if (q == end || *q != *w) {
+                    return false;
+                }
+            }
+            p = q;
+            return true;
+        }
+
+        JsonT ParseValue()
+        {
+            SkipSpaces();
+            if (p == end) {
+                throw runtime_error("Unexpected end of the text.");
+            }
+            JsonT value;
+            if (Accept('{')) {
+                value.type = JsonT::TypeT::OBJECT;
+                if (!Accept('}')) {
+                    do {
+                        SkipSpaces();
+                        string key = ParseString();
+                        Expect(':');
+                        value.object.emplace_back(move(key), ParseValue());
+                    } while (Accept(','));
+                    Expect('}');
+                }
+            } else if (Accept('[')) {
+                value.type = JsonT::TypeT::ARRAY;
+                if (!Accept(']')) {
+                    do {
+                        value.array.push_back(ParseValue());
+                    } while (Accept(','));
+                    Expect(']');
+                }
+            } else if (*p == '"') {
+                value.type = JsonT::TypeT::STRING;
+                value.text = ParseString();
+            } else if (AcceptWord("true") || AcceptWord("false")) {
+                value.type = JsonT::TypeT::BOOLEAN;
+                value.number = p[-1] == 'e' && p[-2] == 'u' ? 1 : 0;
+            } else if (AcceptWord("null")) {
+                value.type = JsonT::TypeT::NUL;
+            } else {
+                char *q;
+                const string rest(p, end - p < 64 ? end : p + 64);
+                value.number = strtod(rest.c_str(), &q);
+                if (q == rest.c_str()) {
+                    throw runtime_error("Invalid JSON value.");
+                }
+                value.type = JsonT::TypeT::NUMBER;
+                p += q - rest.c_str();
+            }
+            return value;
+        }
+
+        string ParseString()
+        {
+            if (p == end || *p != '"') {
+                throw runtime_error("A string is expected.");
+            }
+            ++p;
+            string s;
+            while (p != end && *p != '"') {
+                if (*p != '\\') {
+                    s += *p++;
+                    continue;
+                }
+                if (++p == end) {
+                    break;
+                }
+                const char c = *p++;
+                switch (c) {
+                case 'n':
+                    s += '\n';
+                    break;
+                case 't':
+                    s += '\t';
+                    break;
+                case 'r':
+                    s += '\r';
+                    break;
+                case 'b':
+                    s += '\b';
+                    break;
+                case 'f':
+                    s += '\f';
+                    break;
+                case 'u': {
+                    // Only the code points in ASCII are written by bench_json.
+                    if (end - p < 4) {
+                        throw runtime_error("Invalid \\u escape sequence.");
+                    }
+                    const string hex(p, p + 4);
+                    s += static_cast<char>(strtoul(hex.c_str(), nullptr, 16));
+                    p += 4;
+                    break;
+                }
+                default:
+                    s += c;
+                    break;
+                }
+            }
+            if (p == end) {
+                throw runtime_error("Unterminated string.");
+            }
+            ++p;
+            return s;
+        }
+
+        const char *p;
+        const char *const end;
+    };
+
+    // A result of a benchmark.
+    struct ResultT {
+        double mean;
+        double stddev;
+        double samples;
+        double allocations;
+    };
+
+    double get_number(const JsonT &object, const char *key)
+    {
+        const JsonT *const value = object.Find(key);
+        if (value == nullptr || value->type != JsonT::TypeT::NUMBER) {
+            throw runtime_error(string("\"") + key + "\" isn't found.");
+        }
+        return value->number;
+    }
+
+    // Read the results in the order of the file.
+    vector<pair<string, ResultT>> read_results(const char *path)
+    {
+        ifstream is(path, ios::binary);
+        if (!is) {
+            throw runtime_error(string(path) + ": Can't open the file.");
+        }
+        const string text((istreambuf_iterator<char>(is)), istreambuf_iterator<char>());
+        vector<pair<string, ResultT>> results;
+        try {
+            const JsonT root = JsonParser(text).Parse();
+            const JsonT *const benchmarks = root.Find("benchmarks");
+            if (benchmarks == nullptr || benchmarks->type != JsonT::TypeT::ARRAY) {
+                throw runtime_error("\"benchmarks\" isn't found.");
+            }
+            for (const auto &b : benchmarks->array) {
+                const JsonT *const name = b.Find("name");
+                if (name == nullptr || name->type != JsonT::TypeT::STRING) {
+                    throw runtime_error("\"name\" isn't found.");
+                }
+                ResultT r;
+                r.mean = get_number(b, "mean_ns");
+                r.stddev = get_number(b, "stddev_ns");
+                r.samples = get_number(b, "samples");
+                r.allocations = get_number(b, "allocations");
+                results.emplace_back(name->text, r);
+            }
+        } catch (const runtime_error &e) {
+            throw runtime_error(string(path) + ": " + e.what());
+        }
+        return results;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    double threshold = 5.0;
+    double tLimit = 3.0;
+    vector<const char *> paths;
+    for (int i = 1; i < argc; ++i) {
+        const string arg(argv[i]);
+        if (arg == "-h" || arg == "--help") {
+            usage(cout);
+            return 0;
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = strtod(argv[++i], nullptr);
+        } else if (arg == "--t" && i + 1 < argc) {
+            tLimit = strtod(argv[++i], nullptr);
+        } else if (!arg.empty() && arg[0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            usage(cerr);
+            return 2;
+        }
+    }
+    if (paths.size() != 2) {
+        usage(cerr);
+        return 2;
+    }
+
+    vector<pair<string, ResultT>> base;
+    map<string, ResultT> current;
+    try {
+        base = read_results(paths[0]);
+        for (auto &it : read_results(paths[1])) {
+            current.insert(move(it));
+        }
+    } catch (const runtime_error &e) {
+        cerr << e.what() << endl;
+        return 2;
+    }
+
+    size_t regressions = 0;
+    printf("%-60s %12s %12s %8s %7s %s\n", "benchmark", "base ns", "new ns", "change", "t", "allocations");
+    for (const auto &it : base) {
+        const string &name = it.first;
+        const ResultT &a = it.second;
+        const auto found = current.find(name);
+        if (found == current.end()) {
+            printf("%-60s (not in %s)\n", name.c_str(), paths[1]);
+            continue;
+        }
+        const ResultT &b = found->second;
+        current.erase(found);
+
+        const double change = a.mean > 0 ? (b.mean - a.mean) / a.mean * 100 : 0;
+        // Welch's t statistic.
+        const double se = sqrt(a.stddev * a.stddev / a.samples + b.stddev * b.stddev / b.samples);
+        const double t = se > 0 ? (b.mean - a.mean) / se : (b.mean > a.mean ? INFINITY : b.mean < a.mean ? -INFINITY : 0);
+        const bool slower = change > threshold && t > tLimit;
+        const bool faster = change < -threshold && t < -tLimit;
+        // The allocations per iteration are deterministic, so any increase is a regression.
+        const bool moreAllocations = b.allocations > a.allocations + 0.001;
+        const char *status = "";
+        if (slower || moreAllocations) {
+            status = "  REGRESSION";
+            ++regressions;
+        } else if (faster) {
+            status = "  improved";
+        }
+        printf("%-60s %12.1f %12.1f %+7.1f%% %7.1f %.3f -> %.3f%s\n",
+            name.c_str(), a.mean, b.mean, change, t, a.allocations, b.allocations, status);
+    }
+    for (const auto &it : current) {
+        printf("%-60s (not in %s)\n", it.first.c_str(), paths[0]);
+    }
+    printf("%zu regression(s).\n", regressions);
+    return regressions == 0 ? 0 : 1;
+}
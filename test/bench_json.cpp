@@ -0,0 +1,253 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// Run the benchmarks of the loading, the lookups, and the plural functions, and write the results in JSON.
+// The results of two runs are compared by bench_compare.
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "spiritless_po.h"
+#include "BenchmarkRunner.h"
+#include "PoCorpusGenerator.h"
+
+using namespace std;
+using namespace spiritless_po;
+
+namespace {
+    void usage(ostream &os)
+    {
+        const bench_runner::OptionsT d;
+        os << "Usage: bench_json [options] > result.json" << endl
+           << "  -o FILE             Write the results into FILE instead of the standard output." << endl
+           << "  --samples N         The number of the samples. (" << d.samples << ")" << endl
+           << "  --sample-time S     The minimum time of a sample in seconds. (" << d.minSampleTime << ")" << endl
+           << "  --filter TEXT       Run only the benchmarks whose names contain TEXT." << endl;
+    }
+
+    // A corpus and the parameters that make it.
+    struct CorpusT {
+        string name;
+        bench_runner::ParametersT parameters;
+        string text;
+    };
+
+    CorpusT make_corpus(const string &name, const po_corpus::OptionsT &options)
+    {
+        CorpusT corpus;
+        corpus.name = name;
+        corpus.parameters = {
+            { "corpus", name },
+            { "seed", to_string(options.seed) },
+            { "entries", to_string(options.entries) },
+            { "nplurals", to_string(options.nplurals) },
+            { "minLength", to_string(options.minLength) },
+            { "meanLength", to_string(options.meanLength) },
+            { "maxLength", to_string(options.maxLength) },
+            { "escapeRatio", to_string(options.escapeRatio) },
+            { "contextRatio", to_string(options.contextRatio) },
+            { "pluralRatio", to_string(options.pluralRatio) },
+        };
+        corpus.text = po_corpus::PoCorpusGenerator(options).Generate();
+        return corpus;
+    }
+
+    vector<CorpusT> make_corpora()
+    {
+        vector<CorpusT> corpora;
+        po_corpus::OptionsT options;
+        options.entries = 1000;
+        corpora.push_back(make_corpus("1k", options));
+        options.entries = 50000;
+        corpora.push_back(make_corpus("50k", options));
+        po_corpus::OptionsT complex(options);
+        complex.nplurals = 3;
+        complex.escapeRatio = 0.3;
+        complex.contextRatio = 0.5;
+        complex.pluralRatio = 0.5;
+        corpora.push_back(make_corpus("50k complex", complex));
+        return corpora;
+    }
+
+    // A stream buffer that reads the memory without copying.
+    class MemoryBuffer : public streambuf {
+    public:
+        MemoryBuffer(const char *begin, const char *end)
+        {
+            char *const p = const_cast<char *>(begin);
+            setg(p, p, p + (end - begin));
+        }
+    };
+
+    void run_load(bench_runner::Runner &runner, const CorpusT &corpus)
+    {
+        const string &text = corpus.text;
+        runner.Run("Catalog::Add(const char *) " + corpus.name, corpus.parameters, [&text]() {
+            Catalog catalog;
+            catalog.Add(text.data(), text.data() + text.size());
+            return catalog.GetIndex().size();
+        });
+        runner.Run("Catalog::Add(is) " + corpus.name, corpus.parameters, [&text]() {
+            MemoryBuffer buf(text.data(), text.data() + text.size());
+            istream is(&buf);
+            Catalog catalog;
+            catalog.Add(is);
+            return catalog.GetIndex().size();
+        });
+        const Catalog source(text.begin(), text.end());
+        runner.Run("Catalog::Merge() " + corpus.name, corpus.parameters, [&source]() {
+            Catalog catalog;
+            catalog.Merge(source);
+            return catalog.GetIndex().size();
+        });
+        runner.Run("Catalog copy constructor " + corpus.name, corpus.parameters, [&source]() {
+            const Catalog catalog(source);
+            return catalog.GetIndex().size();
+        });
+        runner.Run("LazyCatalog::Add() " + corpus.name, corpus.parameters, [&text]() {
+            LazyCatalog catalog;
+            catalog.Add(text);
+            return catalog.GetStatistics().translatedCount;
+        });
+    }
+
+    // The entries have 3 long msgstr, so the loading of LazyCatalog, which doesn't decode msgstr, is compared with Catalog.
+    void run_lazy_load(bench_runner::Runner &runner)
+    {
+        po_corpus::OptionsT options;
+        options.entries = 50000;
+        options.nplurals = 3;
+        options.pluralRatio = 1.0;
+        options.meanLength = 200;
+        options.maxLength = 2000;
+        const CorpusT corpus = make_corpus("50k long msgstr", options);
+        const string &text = corpus.text;
+        runner.Run("Catalog::Add(const char *) " + corpus.name, corpus.parameters, [&text]() {
+            Catalog catalog;
+            catalog.Add(text.data(), text.data() + text.size());
+            return catalog.GetIndex().size();
+        });
+        runner.Run("LazyCatalog::Add() " + corpus.name, corpus.parameters, [&text]() {
+            LazyCatalog catalog;
+            catalog.Add(text);
+            return catalog.GetStatistics().translatedCount;
+        });
+    }
+
+    // Each iteration looks up a key.
+    void run_lookup(bench_runner::Runner &runner, const CorpusT &corpus)
+    {
+        const Catalog catalog(corpus.text.begin(), corpus.text.end());
+        vector<string> ids;
+        vector<string> missingIds;
+        vector<pair<string, string>> contextIds;
+        for (const auto &it : catalog.GetIndex()) {
+            const size_t separator = it.first.find(CONTEXT_SEPARATOR);
+            if (separator == string::npos) {
+                ids.push_back(it.first);
+                missingIds.push_back("missing " + it.first);
+            } else {
+                contextIds.emplace_back(it.first.substr(0, separator), it.first.substr(separator + 1));
+            }
+        }
+        const string plural("plural");
+        size_t i = 0;
+        runner.Run("Catalog::gettext() hit " + corpus.name, corpus.parameters, [&]() {
+            return catalog.gettext(ids[i++ % ids.size()]).size();
+        });
+        runner.Run("Catalog::gettext() miss " + corpus.name, corpus.parameters, [&]() {
+            return catalog.gettext(missingIds[i++ % missingIds.size()]).size();
+        });
+        runner.Run("Catalog::ngettext() " + corpus.name, corpus.parameters, [&]() {
+            ++i;
+            return catalog.ngettext(ids[i % ids.size()], plural, i).size();
+        });
+        if (!contextIds.empty()) {
+            runner.Run("Catalog::pgettext() " + corpus.name, corpus.parameters, [&]() {
+                const auto &id = contextIds[i++ % contextIds.size()];
+                return catalog.pgettext(id.first, id.second).size();
+            });
+            runner.Run("Catalog::npgettext() " + corpus.name, corpus.parameters, [&]() {
+                ++i;
+                const auto &id = contextIds[i % contextIds.size()];
+                return catalog.npgettext(id.first, id.second, plural, i).size();
+            });
+        }
+    }
+
+    // Each iteration evaluates the plural function for 1000 values of n.
+    void run_plural(bench_runner::Runner &runner)
+    {
+        const char *const expressions[] = {
+            "n != 1",
+            "n%10==1 && n%100!=11 ? 0 : n%10>=2 && (n%100<10 || n%100>=20) ? 1 : 2",
+            "n%7==1 ? 0 : n%7==2 ? 1 : 2",
+            "n==0 ? 0 : n%100>=3 && n%100<=10 ? 3 : n%7==1 ? 1 : 2",
+        };
+        for (const char *const expression : expressions) {
+            const PluralParser::FunctionType f = PluralParser::Parse(expression);
+            runner.Run(string("PluralParser::FunctionType ") + expression, { { "expression", expression } }, [&f]() {
+                size_t sum = 0;
+                for (unsigned long n = 0; n < 1000; ++n) {
+                    sum += f(n);
+                }
+                return sum;
+            });
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bench_runner::OptionsT options;
+    string output;
+    for (int i = 1; i < argc; ++i) {
+        const string arg(argv[i]);
+        if (arg == "-h" || arg == "--help") {
+            usage(cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            usage(cerr);
+            return 2;
+        }
+        const char *const value = argv[++i];
+        if (arg == "-o") {
+            output = value;
+        } else if (arg == "--samples") {
+            options.samples = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (arg == "--sample-time") {
+            options.minSampleTime = strtod(value, nullptr);
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else {
+            usage(cerr);
+            return 2;
+        }
+    }
+    if (options.samples == 0) {
+        usage(cerr);
+        return 2;
+    }
+
+    bench_runner::Runner runner(options);
+    for (const auto &corpus : make_corpora()) {
+        run_load(runner, corpus);
+        run_lookup(runner, corpus);
+    }
+    run_lazy_load(runner);
+    run_plural(runner);
+
+    if (output.empty()) {
+        runner.WriteJson(cout);
+        return cout ? 0 : 1;
+    }
+    ofstream os(output);
+    runner.WriteJson(os);
+    return os ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+  Copyright © 2026 OOTA, Masato
+  License: CC-BY-SA-3.0
+  See https://creativecommons.org/licenses/by-sa/3.0/legalcode for license details.
+*/
+// Write a synthetic PO corpus to the standard output.
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "PoCorpusGenerator.h"
+
+using namespace std;
+
+namespace {
+    void usage(ostream &os)
+    {
+        const po_corpus::OptionsT d;
+        os << "Usage: gen_po_corpus [options] > corpus.po" << endl
+           << "  --seed N            The seed of the random numbers. (" << d.seed << ")" << endl
+           << "  --entries N         The number of the entries. (" << d.entries << ")" << endl
+           << "  --no-header         Don't generate the header entry." << endl
+           << "  --nplurals N        nplurals. (" << d.nplurals << ")" << endl
+           << "  --uniform-length    The length of msgid is uniform in [min, max]. (default: exponential)" << endl
+           << "  --min-length N      The minimum length of msgid. (" << d.minLength << ")" << endl
+           << "  --mean-length N     The mean length of msgid. (" << d.meanLength << ")" << endl
+           << "  --max-length N      The maximum length of msgid. (" << d.maxLength << ")" << endl
+           << "  --escape-ratio R    The ratio of the escape sequences to the words. (" << d.escapeRatio << ")" << endl
+           << "  --context-ratio R   The ratio of the entries that have msgctxt. (" << d.contextRatio << ")" << endl
+           << "  --plural-ratio R    The ratio of the entries that have msgid_plural. (" << d.pluralRatio << ")" << endl
+           << "  --fuzzy-ratio R     The ratio of the fuzzy entries. (" << d.fuzzyRatio << ")" << endl
+           << "  --comment-ratio R   The ratio of the entries that have the comments. (" << d.commentRatio << ")" << endl
+           << "  --error-ratio R     The ratio of the malformed entries. (" << d.errorRatio << ")" << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    po_corpus::OptionsT options;
+    for (int i = 1; i < argc; ++i) {
+        const string arg(argv[i]);
+        if (arg == "--no-header") {
+            options.header = false;
+            continue;
+        }
+        if (arg == "--uniform-length") {
+            options.lengthDistribution = po_corpus::LengthDistributionT::UNIFORM;
+            continue;
+        }
+        if (arg == "-h" || arg == "--help") {
+            usage(cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            usage(cerr);
+            return 2;
+        }
+        const char *const value = argv[++i];
+        if (arg == "--seed") {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--entries") {
+            options.entries = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (arg == "--nplurals") {
+            options.nplurals = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+        } else if (arg == "--min-length") {
+            options.minLength = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (arg == "--mean-length") {
+            options.meanLength = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (arg == "--max-length") {
+            options.maxLength = static_cast<size_t>(strtoull(value, nullptr, 10));
+        } else if (arg == "--escape-ratio") {
+            options.escapeRatio = strtod(value, nullptr);
+        } else if (arg == "--context-ratio") {
+            options.contextRatio = strtod(value, nullptr);
+        } else if (arg == "--plural-ratio") {
+            options.pluralRatio = strtod(value, nullptr);
+        } else if (arg == "--fuzzy-ratio") {
+            options.fuzzyRatio = strtod(value, nullptr);
+        } else if (arg == "--comment-ratio") {
+            options.commentRatio = strtod(value, nullptr);
+        } else if (arg == "--error-ratio") {
+            options.errorRatio = strtod(value, nullptr);
+        } else {
+            usage(cerr);
+            return 2;
+        }
+    }
+
+    po_corpus::PoCorpusGenerator generator(options);
+    generator.Generate([](const string &chunk) {
+        cout.write(chunk.data(), static_cast<streamsize>(chunk.size()));
+    });
+    const po_corpus::CountsT &counts = generator.GetCounts();
+    cerr << "entries " << counts.entries << ", contexts " << counts.contexts << ", plurals " << counts.plurals
+         << ", fuzzy " << counts.fuzzy << ", errors " << counts.errors << endl;
+    return cout ? 0 : 1;
+}
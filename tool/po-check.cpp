@@ -0,0 +1,196 @@
+/* tool/po-check.cpp
+
+Copyright (c) 2026 OOTA, Masato
+
+This is published under CC0 1.0.
+For more information, see CC0 1.0 Universal (CC0 1.0) at <https://creativecommons.org/publicdomain/zero/1.0/legalcode>.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spiritless_po.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+    struct FileResultT {
+        spiritless_po::Catalog::StatisticsT statistics;
+        vector<string> errors;
+        size_t bytes;
+        bool checked;
+    };
+
+    void usage(ostream &os)
+    {
+        os << "Usage: po-check [options] file..." << endl
+           << "Check PO files, and report the statistics." << endl
+           << endl
+           << "Options:" << endl
+           << "  -j N, --jobs N  Check N files at the same time. (default: the number of the CPUs)" << endl
+           << "  --fail-fast     Stop checking the rest of the files after an error is found." << endl
+           << "  -q, --quiet     Don't report the statistics of each file." << endl
+           << "  -h, --help      Show this message." << endl
+           << endl
+           << "The exit status is 0 if no error is found, 1 if some errors are found, or 2 if the options are wrong." << endl;
+    }
+
+    size_t get_file_size(const string &path)
+    {
+        ifstream f(path, ios::binary | ios::ate);
+        const streamoff size = f ? static_cast<streamoff>(f.tellg()) : 0;
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    // Convert "line,column: message" into "path:line:column: message".
+    string format_error(const string &path, const string &error)
+    {
+        const size_t comma = error.find_first_not_of("0123456789");
+        if (comma != string::npos && comma > 0 && error[comma] == ',') {
+            const size_t colon = error.find_first_not_of("0123456789", comma + 1);
+            if (colon != string::npos && colon > comma + 1 && error.compare(colon, 2, ": ") == 0) {
+                return path + ':' + error.substr(0, comma) + ':' + error.substr(comma + 1);
+            }
+        }
+        return path + ": " + error;
+    }
+
+    void check_file(const string &path, FileResultT &result)
+    {
+        spiritless_po::Catalog catalog;
+        catalog.AddFile(path.c_str());
+        result.statistics = catalog.GetStatistics();
+        result.errors = catalog.GetError();
+        result.bytes = get_file_size(path);
+        result.checked = true;
+    }
+
+    void print_statistics(ostream &os, const spiritless_po::Catalog::StatisticsT &statistics, size_t errors)
+    {
+        os << "total " << statistics.totalCount
+           << ", metadata " << statistics.metadataCount
+           << ", translated " << statistics.translatedCount
+           << ", discarded " << statistics.discardedCount
+           << ", errors " << errors << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int jobs = thread::hardware_concurrency();
+    bool failFast = false;
+    bool quiet = false;
+    vector<string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const string arg(argv[i]);
+        if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 >= argc || atoi(argv[i + 1]) <= 0) {
+                cerr << "po-check: " << arg << " needs a positive number." << endl;
+                return 2;
+            }
+            jobs = static_cast<unsigned int>(atoi(argv[++i]));
+        } else if (arg == "--fail-fast") {
+            failFast = true;
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage(cout);
+            return 0;
+        } else if (arg == "--") {
+            paths.insert(paths.end(), argv + i + 1, argv + argc);
+            break;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            cerr << "po-check: Unknown option: " << arg << endl;
+            usage(cerr);
+            return 2;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        usage(cerr);
+        return 2;
+    }
+    if (jobs == 0) {
+        jobs = 1;
+    }
+    jobs = static_cast<unsigned int>(min<size_t>(jobs, paths.size()));
+
+    // Each thread takes the next file when it has finished the previous one.
+    const auto start_time = steady_clock::now();
+    vector<FileResultT> results(paths.size(), FileResultT{ spiritless_po::Catalog::StatisticsT{}, vector<string>(), 0, false });
+    atomic<size_t> next(0);
+    atomic<bool> stop(false);
+    auto worker = [&]() {
+        for (;;) {
+            if (stop) {
+                break;
+            }
+            const size_t i = next++;
+            if (i >= paths.size()) {
+                break;
+            }
+            check_file(paths[i], results[i]);
+            if (failFast && !results[i].errors.empty()) {
+                stop = true;
+            }
+        }
+    };
+    vector<thread> threads;
+    for (unsigned int i = 1; i < jobs; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &th : threads) {
+        th.join();
+    }
+    const auto end_time = steady_clock::now();
+
+    spiritless_po::Catalog::StatisticsT total{};
+    size_t totalErrors = 0;
+    size_t totalBytes = 0;
+    size_t checkedFiles = 0;
+    size_t errorFiles = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const FileResultT &result = results[i];
+        if (!result.checked) {
+            continue;
+        }
+        for (const auto &error : result.errors) {
+            cerr << format_error(paths[i], error) << endl;
+        }
+        if (!quiet) {
+            cout << paths[i] << ": ";
+            print_statistics(cout, result.statistics, result.errors.size());
+        }
+        total.totalCount += result.statistics.totalCount;
+        total.metadataCount += result.statistics.metadataCount;
+        total.translatedCount += result.statistics.translatedCount;
+        total.discardedCount += result.statistics.discardedCount;
+        totalErrors += result.errors.size();
+        totalBytes += result.bytes;
+        ++checkedFiles;
+        if (!result.errors.empty()) {
+            ++errorFiles;
+        }
+    }
+
+    const double seconds = duration_cast<duration<double>>(end_time - start_time).count();
+    const double megaBytes = totalBytes / 1e6;
+    cout << "Total: ";
+    print_statistics(cout, total, totalErrors);
+    cout << "Checked " << checkedFiles << " of " << paths.size() << " files (" << errorFiles << " with errors), "
+         << fixed << setprecision(3) << megaBytes << " MB in " << seconds << " s, "
+         << setprecision(1) << (seconds > 0 ? megaBytes / seconds : 0.0) << " MB/s, jobs " << jobs << '.' << endl;
+    return totalErrors == 0 && checkedFiles == paths.size() ? 0 : 1;
+}